@@ -0,0 +1,670 @@
+/**
+ * Bitboard board representation.
+ *
+ * The position is kept as twelve 64-bit masks (one per color and piece type)
+ * plus per-color and total occupancy masks. Every query is a handful of
+ * integer operations instead of walking a grid of heap-allocated pieces.
+ * A 64-byte mailbox of PieceCode values mirrors the masks so "what stands
+ * on this square" is a single load.
+ *
+ * Squares are numbered rank-major to match Position(x, y) in chess.cpp:
+ * x is the rank (row 0 holds white's back rank) and y is the file, so
+ * square = x * 8 + y.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#include "pst.h"
+#include "zobrist.h"
+
+enum class PieceType {
+    PAWN, ROOK, KNIGHT, BISHOP, QUEEN, KING
+};
+
+enum class Color {
+    WHITE, BLACK
+};
+
+using Bitboard = uint64_t;
+
+inline int squareIndex(int x, int y) {
+    return x * 8 + y;
+}
+
+inline Bitboard squareMask(int square) {
+    return Bitboard(1) << square;
+}
+
+inline int colorIndex(Color c) {
+    return static_cast<int>(c);
+}
+
+inline int typeIndex(PieceType t) {
+    return static_cast<int>(t);
+}
+
+inline Color opposite(Color c) {
+    return (c == Color::WHITE) ? Color::BLACK : Color::WHITE;
+}
+
+inline int popCount(Bitboard bb) {
+    return __builtin_popcountll(bb);
+}
+
+inline int lsb(Bitboard bb) {
+    return __builtin_ctzll(bb);
+}
+
+// Returns the lowest set square and clears it from the mask
+inline int popLsb(Bitboard& bb) {
+    int square = lsb(bb);
+    bb &= bb - 1;
+    return square;
+}
+
+// A piece as a plain byte: bits 0-2 hold the type, bit 3 the color
+using PieceCode = uint8_t;
+const PieceCode NO_PIECE = 0xF;
+
+inline PieceCode makePiece(Color c, PieceType t) {
+    return static_cast<PieceCode>((colorIndex(c) << 3) | typeIndex(t));
+}
+
+inline PieceType pieceType(PieceCode p) {
+    return static_cast<PieceType>(p & 7);
+}
+
+inline Color pieceColor(PieceCode p) {
+    return static_cast<Color>(p >> 3);
+}
+
+inline char pieceSymbol(Color c, PieceType t) {
+    static const char symbols[] = "PRNBQK";
+    char s = symbols[typeIndex(t)];
+    return (c == Color::WHITE) ? s : static_cast<char>(s - 'A' + 'a'); // Uppercase for white, lowercase for black
+}
+
+// Castling rights bits
+enum CastlingRight {
+    WHITE_KINGSIDE = 1,
+    WHITE_QUEENSIDE = 2,
+    BLACK_KINGSIDE = 4,
+    BLACK_QUEENSIDE = 8
+};
+
+// Move flag bits
+enum MoveFlag {
+    MOVE_QUIET = 0,
+    MOVE_CAPTURE = 1,
+    MOVE_DOUBLE_PUSH = 2,
+    MOVE_EN_PASSANT = 4,
+    MOVE_CASTLING = 8,
+    MOVE_PROMOTION = 16
+};
+
+// A move packed into 16 bits: from (6) | to (6) | kind (4). Kinds are
+// 0 quiet, 1 double pawn push, 2 castling, 4 capture, 5 en passant,
+// 8-11 promotion to knight/bishop/rook/queen and 12-15 the same with a
+// capture, so bit 2 marks captures and bit 3 promotions.
+class Move {
+public:
+    Move() : data(0) {}
+    Move(int from, int to, int flags = MOVE_QUIET, PieceType promotion = PieceType::QUEEN)
+        : data(static_cast<uint16_t>(from | (to << 6) | (encodeKind(flags, promotion) << 12))) {}
+
+    int from() const { return data & 0x3F; }
+    int to() const { return (data >> 6) & 0x3F; }
+
+    // The kind decoded back into MoveFlag bits
+    int flags() const {
+        static const uint8_t KIND_FLAGS[16] = {
+            MOVE_QUIET, MOVE_DOUBLE_PUSH, MOVE_CASTLING, MOVE_QUIET,
+            MOVE_CAPTURE, MOVE_CAPTURE | MOVE_EN_PASSANT, MOVE_QUIET, MOVE_QUIET,
+            MOVE_PROMOTION, MOVE_PROMOTION, MOVE_PROMOTION, MOVE_PROMOTION,
+            MOVE_PROMOTION | MOVE_CAPTURE, MOVE_PROMOTION | MOVE_CAPTURE,
+            MOVE_PROMOTION | MOVE_CAPTURE, MOVE_PROMOTION | MOVE_CAPTURE
+        };
+        return KIND_FLAGS[data >> 12];
+    }
+
+    // Only meaningful for promotions
+    PieceType promotion() const {
+        static const PieceType PROMOTIONS[4] = {
+            PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN
+        };
+        return PROMOTIONS[(data >> 12) & 3];
+    }
+
+    bool isCapture() const { return (data & 0x4000) != 0; }
+    bool isPromotion() const { return (data & 0x8000) != 0; }
+    bool isNull() const { return data == 0; }
+
+    uint16_t raw() const { return data; }
+    static Move fromRaw(uint16_t raw) {
+        Move move;
+        move.data = raw;
+        return move;
+    }
+
+    bool operator==(const Move& other) const {
+        return data == other.data;
+    }
+
+private:
+    uint16_t data;
+
+    static int encodeKind(int flags, PieceType promotion) {
+        if (flags & MOVE_PROMOTION) {
+            int piece = 3;
+            switch (promotion) {
+                case PieceType::KNIGHT: piece = 0; break;
+                case PieceType::BISHOP: piece = 1; break;
+                case PieceType::ROOK: piece = 2; break;
+                default: break;
+            }
+            return 8 | ((flags & MOVE_CAPTURE) ? 4 : 0) | piece;
+        }
+        if (flags & MOVE_EN_PASSANT) return 5;
+        if (flags & MOVE_CAPTURE) return 4;
+        if (flags & MOVE_CASTLING) return 2;
+        if (flags & MOVE_DOUBLE_PUSH) return 1;
+        return 0;
+    }
+};
+
+// What makeMove overwrites, so unmakeMove can restore it without a board copy
+struct UndoInfo {
+    uint64_t hash;
+    uint16_t halfmoveClock;
+    int8_t enPassant;
+    uint8_t castlingRights;
+    PieceType moved;
+    PieceType captured;     // Only meaningful if the move was a capture
+};
+
+struct BoardState {
+    Bitboard pieces[2][6];  // One mask per color and piece type
+    Bitboard occupancy[2];  // All pieces of one color
+    Bitboard occupied;      // Pieces of both colors
+    PieceCode board[64];       // Mailbox mirror of the masks for O(1) square lookups
+    Color sideToMove;
+    int castlingRights;     // CastlingRight bits
+    int enPassant;          // Square a pawn can capture onto en passant, or -1
+    int halfmoveClock;      // Plies since the last capture or pawn move
+    int fullmoveNumber;
+    uint64_t hash;          // Zobrist key, kept up to date by every mutation
+    int mgScore;            // Piece-square sums (pst.h), white minus black, also
+    int egScore;            // kept up to date by every mutation
+    int phase;
+
+    BoardState() {
+        clear();
+    }
+
+    void clear() {
+        for (int c = 0; c < 2; c++) {
+            for (int t = 0; t < 6; t++) {
+                pieces[c][t] = 0;
+            }
+            occupancy[c] = 0;
+        }
+        occupied = 0;
+        for (int sq = 0; sq < 64; sq++) {
+            board[sq] = NO_PIECE;
+        }
+        sideToMove = Color::WHITE;
+        castlingRights = 0;
+        enPassant = -1;
+        halfmoveClock = 0;
+        fullmoveNumber = 1;
+        hash = 0;
+        mgScore = 0;
+        egScore = 0;
+        phase = 0;
+    }
+
+    void addPiece(Color c, PieceType t, int square) {
+        Bitboard mask = squareMask(square);
+        pieces[colorIndex(c)][typeIndex(t)] |= mask;
+        occupancy[colorIndex(c)] |= mask;
+        occupied |= mask;
+        board[square] = makePiece(c, t);
+        hash ^= ZOBRIST.piece[colorIndex(c)][typeIndex(t)][square];
+        mgScore += PST.mg[colorIndex(c)][typeIndex(t)][square];
+        egScore += PST.eg[colorIndex(c)][typeIndex(t)][square];
+        phase += PST.phase[typeIndex(t)];
+    }
+
+    void removePiece(Color c, PieceType t, int square) {
+        Bitboard mask = ~squareMask(square);
+        pieces[colorIndex(c)][typeIndex(t)] &= mask;
+        occupancy[colorIndex(c)] &= mask;
+        occupied &= mask;
+        board[square] = NO_PIECE;
+        hash ^= ZOBRIST.piece[colorIndex(c)][typeIndex(t)][square];
+        mgScore -= PST.mg[colorIndex(c)][typeIndex(t)][square];
+        egScore -= PST.eg[colorIndex(c)][typeIndex(t)][square];
+        phase -= PST.phase[typeIndex(t)];
+    }
+
+    void movePiece(Color c, PieceType t, int from, int to) {
+        Bitboard mask = squareMask(from) | squareMask(to);
+        pieces[colorIndex(c)][typeIndex(t)] ^= mask;
+        occupancy[colorIndex(c)] ^= mask;
+        occupied ^= mask;
+        board[to] = board[from];
+        board[from] = NO_PIECE;
+        hash ^= ZOBRIST.piece[colorIndex(c)][typeIndex(t)][from] ^
+                ZOBRIST.piece[colorIndex(c)][typeIndex(t)][to];
+        mgScore += PST.mg[colorIndex(c)][typeIndex(t)][to] - PST.mg[colorIndex(c)][typeIndex(t)][from];
+        egScore += PST.eg[colorIndex(c)][typeIndex(t)][to] - PST.eg[colorIndex(c)][typeIndex(t)][from];
+    }
+
+    bool isEmpty(int square) const {
+        return (occupied & squareMask(square)) == 0;
+    }
+
+    bool isOccupiedBy(int square, Color c) const {
+        return (occupancy[colorIndex(c)] & squareMask(square)) != 0;
+    }
+
+    // Looks up which piece (if any) stands on a square
+    bool pieceAt(int square, Color& color, PieceType& type) const {
+        PieceCode p = board[square];
+        if (p == NO_PIECE) {
+            return false;
+        }
+        color = pieceColor(p);
+        type = pieceType(p);
+        return true;
+    }
+
+    PieceCode pieceOn(int square) const {
+        return board[square];
+    }
+
+    // Hash of everything except piece placement, which add/remove/move keep current
+    uint64_t stateKey() const {
+        uint64_t key = ZOBRIST.castling[castlingRights];
+        if (enPassant >= 0) {
+            key ^= ZOBRIST.enPassantFile[enPassant % 8];
+        }
+        if (sideToMove == Color::BLACK) {
+            key ^= ZOBRIST.blackToMove;
+        }
+        return key;
+    }
+
+    // Full rehash from scratch; only for setup and consistency checks
+    uint64_t computeHash() const {
+        uint64_t key = stateKey();
+        for (int c = 0; c < 2; c++) {
+            for (int t = 0; t < 6; t++) {
+                Bitboard bb = pieces[c][t];
+                while (bb) {
+                    key ^= ZOBRIST.piece[c][t][popLsb(bb)];
+                }
+            }
+        }
+        return key;
+    }
+
+    // Full recompute of the piece-square sums; only for setup and consistency
+    // checks. Each rank of a piece's bitboard selects entries of its table row
+    // through a lane mask, eight files at a time, so the loop vectorizes. A file
+    // holds at most eight pieces, so the per-file sums fit in 16 bits.
+    void computeScores(int& mg, int& eg, int& gamePhase) const {
+        int16_t mgFiles[8] = {}, egFiles[8] = {};
+        gamePhase = 0;
+        for (int c = 0; c < 2; c++) {
+            for (int t = 0; t < 6; t++) {
+                Bitboard bb = pieces[c][t];
+                const int16_t* mgRow = PST.mg[c][t];
+                const int16_t* egRow = PST.eg[c][t];
+                for (int rank = 0; rank < 8; rank++) {
+                    const int16_t* mask = PST.laneMask[(bb >> (rank * 8)) & 0xFF];
+                    for (int file = 0; file < 8; file++) {
+                        mgFiles[file] += mgRow[rank * 8 + file] & mask[file];
+                        egFiles[file] += egRow[rank * 8 + file] & mask[file];
+                    }
+                }
+                gamePhase += PST.phase[t] * popCount(bb);
+            }
+        }
+        mg = 0;
+        eg = 0;
+        for (int file = 0; file < 8; file++) {
+            mg += mgFiles[file];
+            eg += egFiles[file];
+        }
+    }
+
+    // Static evaluation from white's point of view: midgame and endgame sums
+    // blended by how much material is left
+    int evaluation() const {
+        int p = (phase < PHASE_MAX) ? phase : PHASE_MAX;
+        return (mgScore * p + egScore * (PHASE_MAX - p)) / PHASE_MAX;
+    }
+
+    Bitboard piecesOf(Color c, PieceType t) const {
+        return pieces[colorIndex(c)][typeIndex(t)];
+    }
+
+    int kingSquare(Color c) const {
+        return lsb(piecesOf(c, PieceType::KING));
+    }
+
+    // Applies a move produced by the move generator. Legality is the
+    // generator's job; this only updates the state.
+    void makeMove(const Move& move) {
+        UndoInfo undo;
+        makeMove(move, undo);
+    }
+
+    // Same, recording what is needed to take the move back with unmakeMove
+    void makeMove(const Move& move, UndoInfo& undo) {
+        // Rights lost when a king or rook leaves (or a rook is captured on) its square
+        static const struct CastlingMask {
+            int mask[64];
+            CastlingMask() {
+                for (int sq = 0; sq < 64; sq++) mask[sq] = 0xF;
+                mask[squareIndex(0, 4)] &= ~(WHITE_KINGSIDE | WHITE_QUEENSIDE);
+                mask[squareIndex(0, 7)] &= ~WHITE_KINGSIDE;
+                mask[squareIndex(0, 0)] &= ~WHITE_QUEENSIDE;
+                mask[squareIndex(7, 4)] &= ~(BLACK_KINGSIDE | BLACK_QUEENSIDE);
+                mask[squareIndex(7, 7)] &= ~BLACK_KINGSIDE;
+                mask[squareIndex(7, 0)] &= ~BLACK_QUEENSIDE;
+            }
+        } castling;
+
+        Color us = sideToMove;
+        Color them = opposite(us);
+        undo.hash = hash;
+        undo.halfmoveClock = static_cast<uint16_t>(halfmoveClock);
+        undo.enPassant = static_cast<int8_t>(enPassant);
+        undo.castlingRights = static_cast<uint8_t>(castlingRights);
+        undo.captured = PieceType::PAWN;
+        hash ^= stateKey(); // Out with the old rights, en-passant file and side
+
+        PieceType moving = pieceType(board[move.from()]);
+        undo.moved = moving;
+
+        halfmoveClock++;
+        if (move.flags() & MOVE_EN_PASSANT) {
+            removePiece(them, PieceType::PAWN, (us == Color::WHITE) ? move.to() - 8 : move.to() + 8);
+        } else if (move.flags() & MOVE_CAPTURE) {
+            undo.captured = pieceType(board[move.to()]);
+            removePiece(them, undo.captured, move.to());
+        }
+        if (moving == PieceType::PAWN || (move.flags() & MOVE_CAPTURE)) {
+            halfmoveClock = 0;
+        }
+
+        if (move.flags() & MOVE_PROMOTION) {
+            removePiece(us, PieceType::PAWN, move.from());
+            addPiece(us, move.promotion(), move.to());
+        } else {
+            movePiece(us, moving, move.from(), move.to());
+        }
+
+        if (move.flags() & MOVE_CASTLING) {
+            if (move.to() > move.from()) {
+                movePiece(us, PieceType::ROOK, move.to() + 1, move.to() - 1); // Kingside
+            } else {
+                movePiece(us, PieceType::ROOK, move.to() - 2, move.to() + 1); // Queenside
+            }
+        }
+
+        enPassant = (move.flags() & MOVE_DOUBLE_PUSH) ? (move.from() + move.to()) / 2 : -1;
+        castlingRights &= castling.mask[move.from()] & castling.mask[move.to()];
+        if (us == Color::BLACK) {
+            fullmoveNumber++;
+        }
+        sideToMove = them;
+        hash ^= stateKey();
+    }
+
+    // Reverts the last makeMove(move, undo)
+    void unmakeMove(const Move& move, const UndoInfo& undo) {
+        Color them = sideToMove;
+        Color us = opposite(them);
+        sideToMove = us;
+        if (us == Color::BLACK) {
+            fullmoveNumber--;
+        }
+
+        if (move.flags() & MOVE_CASTLING) {
+            if (move.to() > move.from()) {
+                movePiece(us, PieceType::ROOK, move.to() - 1, move.to() + 1);
+            } else {
+                movePiece(us, PieceType::ROOK, move.to() + 1, move.to() - 2);
+            }
+        }
+
+        if (move.flags() & MOVE_PROMOTION) {
+            removePiece(us, move.promotion(), move.to());
+            addPiece(us, PieceType::PAWN, move.from());
+        } else {
+            movePiece(us, undo.moved, move.to(), move.from());
+        }
+
+        if (move.flags() & MOVE_EN_PASSANT) {
+            addPiece(them, PieceType::PAWN, (us == Color::WHITE) ? move.to() - 8 : move.to() + 8);
+        } else if (move.flags() & MOVE_CAPTURE) {
+            addPiece(them, undo.captured, move.to());
+        }
+
+        // The piece XORs above cancel out; restoring the saved key is cheaper than undoing the rest
+        hash = undo.hash;
+        halfmoveClock = undo.halfmoveClock;
+        enPassant = undo.enPassant;
+        castlingRights = undo.castlingRights;
+    }
+
+    // Loads a position in Forsyth-Edwards Notation. Returns false on malformed
+    // input or a position no game can reach the way it is written: wrong board
+    // size, pawns on the back ranks, a king count other than one per side,
+    // castling rights without the king and rook at home, an en-passant square
+    // with no pawn that just moved past it, or the side not to move in check.
+    bool setFromFen(const std::string& fen) {
+        static const std::string symbols = "PRNBQKprnbqk";
+
+        std::istringstream in(fen);
+        std::string placement, side, castling, ep;
+        if (!(in >> placement >> side >> castling >> ep)) {
+            return false;
+        }
+
+        clear();
+        int rank = 7, file = 0;
+        for (char ch : placement) {
+            if (ch == '/') {
+                if (file != 8 || rank == 0) {
+                    return false;
+                }
+                rank--;
+                file = 0;
+            } else if (ch >= '1' && ch <= '8') {
+                file += ch - '0';
+                if (file > 8) {
+                    return false;
+                }
+            } else {
+                size_t index = symbols.find(ch);
+                if (index == std::string::npos || file > 7) {
+                    return false;
+                }
+                PieceType type = static_cast<PieceType>(index % 6);
+                if (type == PieceType::PAWN && (rank == 0 || rank == 7)) {
+                    return false;
+                }
+                addPiece(static_cast<Color>(index / 6), type, squareIndex(rank, file));
+                file++;
+            }
+        }
+        if (rank != 0 || file != 8) {
+            return false;
+        }
+        if (popCount(piecesOf(Color::WHITE, PieceType::KING)) != 1 ||
+            popCount(piecesOf(Color::BLACK, PieceType::KING)) != 1) {
+            return false;
+        }
+
+        if (side != "w" && side != "b") {
+            return false;
+        }
+        sideToMove = (side == "b") ? Color::BLACK : Color::WHITE;
+
+        if (castling != "-") {
+            for (char ch : castling) {
+                switch (ch) {
+                    case 'K': castlingRights |= WHITE_KINGSIDE; break;
+                    case 'Q': castlingRights |= WHITE_QUEENSIDE; break;
+                    case 'k': castlingRights |= BLACK_KINGSIDE; break;
+                    case 'q': castlingRights |= BLACK_QUEENSIDE; break;
+                    default: return false;
+                }
+            }
+        }
+        auto hasPiece = [this](Color c, PieceType t, int square) {
+            return pieceOn(square) == makePiece(c, t);
+        };
+        // Each right needs its king and rook still on their starting squares
+        static const struct { int right, rank, rookFile; } homes[4] = {
+            { WHITE_KINGSIDE, 0, 7 }, { WHITE_QUEENSIDE, 0, 0 }, { BLACK_KINGSIDE, 7, 7 }, { BLACK_QUEENSIDE, 7, 0 }
+        };
+        for (const auto& home : homes) {
+            Color c = (home.rank == 0) ? Color::WHITE : Color::BLACK;
+            if ((castlingRights & home.right) && (!hasPiece(c, PieceType::KING, squareIndex(home.rank, 4)) ||
+                                                  !hasPiece(c, PieceType::ROOK, squareIndex(home.rank, home.rookFile)))) {
+                return false;
+            }
+        }
+
+        if (ep != "-") {
+            // White to move captures on rank 6 a black pawn that moved to rank 5
+            int epRank = (sideToMove == Color::WHITE) ? 5 : 2;
+            int pawnRank = (sideToMove == Color::WHITE) ? 4 : 3;
+            if (ep.size() != 2 || ep[0] < 'a' || ep[0] > 'h' || ep[1] - '1' != epRank) {
+                return false;
+            }
+            int epFile = ep[0] - 'a';
+            if (!isEmpty(squareIndex(epRank, epFile)) ||
+                !hasPiece(opposite(sideToMove), PieceType::PAWN, squareIndex(pawnRank, epFile))) {
+                return false;
+            }
+            enPassant = squareIndex(epRank, epFile);
+        }
+        if (!(in >> halfmoveClock >> fullmoveNumber)) {
+            halfmoveClock = 0;
+            fullmoveNumber = 1;
+        }
+        hash = computeHash();
+
+        Color waiting = opposite(sideToMove);
+        return !attackedSlowly(kingSquare(waiting), sideToMove);
+    }
+
+    // Ray-walking attack test for checking loaded positions; move generation
+    // uses the tables in attacks.h, which build on this header
+    bool attackedSlowly(int square, Color by) const {
+        int rank = square / 8, file = square % 8;
+        auto holds = [&](int r, int f, PieceType t) {
+            return r >= 0 && r < 8 && f >= 0 && f < 8 && pieceOn(squareIndex(r, f)) == makePiece(by, t);
+        };
+        int pawnRank = (by == Color::WHITE) ? rank - 1 : rank + 1;
+        if (holds(pawnRank, file - 1, PieceType::PAWN) || holds(pawnRank, file + 1, PieceType::PAWN)) {
+            return true;
+        }
+        static const int knightSteps[8][2] = { { 1, 2 }, { 2, 1 }, { 2, -1 }, { 1, -2 },
+                                               { -1, -2 }, { -2, -1 }, { -2, 1 }, { -1, 2 } };
+        for (const auto& step : knightSteps) {
+            if (holds(rank + step[0], file + step[1], PieceType::KNIGHT)) {
+                return true;
+            }
+        }
+        static const int directions[8][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 },
+                                              { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 } };
+        for (int d = 0; d < 8; d++) {
+            PieceType slider = (d < 4) ? PieceType::ROOK : PieceType::BISHOP;
+            int r = rank + directions[d][0], f = file + directions[d][1];
+            if (holds(r, f, PieceType::KING)) {
+                return true;
+            }
+            for (; r >= 0 && r < 8 && f >= 0 && f < 8; r += directions[d][0], f += directions[d][1]) {
+                if (holds(r, f, slider) || holds(r, f, PieceType::QUEEN)) {
+                    return true;
+                }
+                if (!isEmpty(squareIndex(r, f))) {
+                    break;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Writes the position in Forsyth-Edwards Notation
+    std::string toFen() const {
+        std::string fen;
+        for (int rank = 7; rank >= 0; rank--) {
+            int empty = 0;
+            for (int file = 0; file < 8; file++) {
+                Color color;
+                PieceType type;
+                if (!pieceAt(squareIndex(rank, file), color, type)) {
+                    empty++;
+                    continue;
+                }
+                if (empty > 0) {
+                    fen += static_cast<char>('0' + empty);
+                    empty = 0;
+                }
+                fen += pieceSymbol(color, type);
+            }
+            if (empty > 0) {
+                fen += static_cast<char>('0' + empty);
+            }
+            if (rank > 0) {
+                fen += '/';
+            }
+        }
+
+        fen += (sideToMove == Color::WHITE) ? " w " : " b ";
+        if (castlingRights == 0) fen += '-';
+        if (castlingRights & WHITE_KINGSIDE) fen += 'K';
+        if (castlingRights & WHITE_QUEENSIDE) fen += 'Q';
+        if (castlingRights & BLACK_KINGSIDE) fen += 'k';
+        if (castlingRights & BLACK_QUEENSIDE) fen += 'q';
+
+        if (enPassant >= 0) {
+            fen += ' ';
+            fen += static_cast<char>('a' + enPassant % 8);
+            fen += static_cast<char>('1' + enPassant / 8);
+        } else {
+            fen += " -";
+        }
+        fen += ' ' + std::to_string(halfmoveClock) + ' ' + std::to_string(fullmoveNumber);
+        return fen;
+    }
+
+    void setStartPosition() {
+        static const PieceType backRank[8] = {
+            PieceType::ROOK, PieceType::KNIGHT, PieceType::BISHOP, PieceType::QUEEN,
+            PieceType::KING, PieceType::BISHOP, PieceType::KNIGHT, PieceType::ROOK
+        };
+
+        clear();
+        for (int i = 0; i < 8; i++) {
+            addPiece(Color::WHITE, backRank[i], squareIndex(0, i));
+            addPiece(Color::WHITE, PieceType::PAWN, squareIndex(1, i));
+            addPiece(Color::BLACK, PieceType::PAWN, squareIndex(6, i));
+            addPiece(Color::BLACK, backRank[i], squareIndex(7, i));
+        }
+        castlingRights = WHITE_KINGSIDE | WHITE_QUEENSIDE | BLACK_KINGSIDE | BLACK_QUEENSIDE;
+        hash = computeHash();
+    }
+};
@@ -0,0 +1,165 @@
+/**
+ * Opening book in Polyglot's binary layout.
+ *
+ * The file is a sorted array of 16-byte big-endian entries
+ * (key u64, move u16, weight u16, learn u32), several entries per position.
+ * It is mapped read-only and never parsed: a probe is one binary search for
+ * the position's key followed by a weighted pick among its entries.
+ *
+ * Moves use Polyglot's encoding (to file/rank, from file/rank, promotion in
+ * 3-bit fields; castling written as the king taking its own rook). Keys are
+ * Polyglot keys (polyglot.h), so books from book_build and from other
+ * Polyglot tools can be used interchangeably.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "mapped_file.h"
+#include "movegen.h"
+#include "polyglot.h"
+
+const size_t BOOK_ENTRY_SIZE = 16;
+
+struct BookEntry {
+    uint64_t key;
+    uint16_t move;
+    uint16_t weight;
+    uint32_t learn;
+};
+
+inline uint64_t readBigEndian(const unsigned char* p, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+inline void writeBigEndian(unsigned char* p, uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; i--) {
+        p[i] = static_cast<unsigned char>(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+// Polyglot move word; a castling king move becomes king-takes-rook
+inline uint16_t encodeBookMove(const Move& move) {
+    static const int PROMOTION_CODES[6] = { 0, 3, 1, 2, 4, 0 }; // Pawn, Rook, Knight, Bishop, Queen, King
+    int to = move.to();
+    if (move.flags() & MOVE_CASTLING) {
+        to = (move.to() > move.from()) ? move.to() + 1 : move.to() - 2;
+    }
+    int promotion = move.isPromotion() ? PROMOTION_CODES[typeIndex(move.promotion())] : 0;
+    return static_cast<uint16_t>(to | (move.from() << 6) | (promotion << 12));
+}
+
+// Finds the legal move a Polyglot move word stands for
+inline bool decodeBookMove(const BoardState& state, uint16_t word, Move& out) {
+    MoveList legal;
+    generateLegalMoves(state, legal);
+    for (const Move& m : legal) {
+        if (encodeBookMove(m) == word) {
+            out = m;
+            return true;
+        }
+    }
+    return false;
+}
+
+class OpeningBook {
+public:
+    bool open(const std::string& path) {
+        if (!file.open(path) || file.size() % BOOK_ENTRY_SIZE != 0) {
+            return false;
+        }
+        count = static_cast<size_t>(file.size() / BOOK_ENTRY_SIZE);
+        if (count > 0) {
+            region = file.map(0, static_cast<size_t>(file.size()), false);
+        }
+        return count == 0 || region != nullptr;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    BookEntry entry(size_t i) const {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(region->data) + i * BOOK_ENTRY_SIZE;
+        return BookEntry{ readBigEndian(p, 8), static_cast<uint16_t>(readBigEndian(p + 8, 2)),
+                          static_cast<uint16_t>(readBigEndian(p + 10, 2)),
+                          static_cast<uint32_t>(readBigEndian(p + 12, 4)) };
+    }
+
+    // Index of the first entry for `key`, or size() if the position is not in the book
+    size_t find(uint64_t key) const {
+        size_t low = 0, high = count;
+        while (low < high) {
+            size_t mid = low + (high - low) / 2;
+            if (readKey(mid) < key) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return (low < count && readKey(low) == key) ? low : count;
+    }
+
+    // Picks a book move with probability proportional to its weight. `random`
+    // is any uniformly distributed number supplied by the caller.
+    bool probe(const BoardState& state, uint64_t random, Move& out) const {
+        uint64_t key = polyglotKey(state);
+        size_t first = find(key);
+        if (first == count) {
+            return false;
+        }
+        uint64_t total = 0;
+        size_t last = first;
+        for (; last < count && readKey(last) == key; last++) {
+            total += entry(last).weight;
+        }
+        if (total == 0) {
+            return false;
+        }
+        uint64_t pick = random % total;
+        for (size_t i = first; i < last; i++) {
+            BookEntry e = entry(i);
+            if (pick < e.weight) {
+                return decodeBookMove(state, e.move, out);
+            }
+            pick -= e.weight;
+        }
+        return false;
+    }
+
+private:
+    MappedFile file;
+    std::shared_ptr<MappedRegion> region;
+    size_t count = 0;
+
+    uint64_t readKey(size_t i) const {
+        return readBigEndian(reinterpret_cast<const unsigned char*>(region->data) + i * BOOK_ENTRY_SIZE, 8);
+    }
+};
+
+// Writes entries, already sorted by key, as a Polyglot file
+inline bool writeBook(const std::string& path, const BookEntry* entries, size_t count) {
+    FILE* out = std::fopen(path.c_str(), "wb");
+    if (out == nullptr) {
+        return false;
+    }
+    bool ok = true;
+    for (size_t i = 0; i < count && ok; i++) {
+        unsigned char bytes[BOOK_ENTRY_SIZE];
+        writeBigEndian(bytes, entries[i].key, 8);
+        writeBigEndian(bytes + 8, entries[i].move, 2);
+        writeBigEndian(bytes + 10, entries[i].weight, 2);
+        writeBigEndian(bytes + 12, entries[i].learn, 4);
+        ok = std::fwrite(bytes, 1, BOOK_ENTRY_SIZE, out) == BOOK_ENTRY_SIZE;
+    }
+    return std::fclose(out) == 0 && ok;
+}
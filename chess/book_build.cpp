@@ -0,0 +1,114 @@
+/**
+ * Opening book builder: replays a PGN archive and writes the first moves of
+ * every game as a Polyglot book (see book.h).
+ *
+ * Each move is weighted the Polyglot way, 2 for a win and 1 for a draw for
+ * the side that played it, so moves that only ever lost are left out.
+ * Weights are scaled down to fit 16 bits where needed.
+ *
+ * Usage: book_build <games.pgn> <book.bin> [max plies]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "book.h"
+#include "pgn.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: book_build <games.pgn> <book.bin> [max plies]\n";
+        return 1;
+    }
+    int maxPlies = (argc > 3) ? atoi(argv[3]) : 20;
+
+    MappedFile file;
+    if (!file.open(argv[1])) {
+        cerr << "Cannot open " << argv[1] << "\n";
+        return 1;
+    }
+
+    struct Played {
+        uint64_t key;
+        uint16_t move;
+        Color side;
+    };
+    vector<BookEntry> entries;
+    vector<Played> line;
+    uint64_t games = 0, skipped = 0;
+
+    auto start = chrono::steady_clock::now();
+    PgnReader reader(file);
+    bool ok = reader.read([&](GameBatch&& batch) {
+        for (size_t i = 0; i < batch.games.size(); i++) {
+            line.clear();
+            GameStats stats = replayGame(batch.games[i], batch.firstIndex + i,
+                                         [&](const BoardState& state, const Move& move) {
+                if (static_cast<int>(line.size()) < maxPlies) {
+                    line.push_back({ polyglotKey(state), encodeBookMove(move), state.sideToMove });
+                }
+            });
+            games++;
+            if (!stats.error.empty() || (stats.result != "1-0" && stats.result != "0-1" && stats.result != "1/2-1/2")) {
+                skipped++;
+                continue;
+            }
+            for (const Played& p : line) {
+                bool won = (stats.result == "1-0") == (p.side == Color::WHITE);
+                uint16_t weight = (stats.result == "1/2-1/2") ? 1 : won ? 2 : 0;
+                if (weight > 0) {
+                    entries.push_back({ p.key, p.move, weight, 0 });
+                }
+            }
+        }
+    });
+    if (!ok) {
+        cerr << "Cannot read " << argv[1] << "\n";
+        return 1;
+    }
+
+    // Merge repeated (position, move) pairs into one entry
+    sort(entries.begin(), entries.end(), [](const BookEntry& a, const BookEntry& b) {
+        return a.key != b.key ? a.key < b.key : a.move < b.move;
+    });
+    vector<uint64_t> totals;
+    size_t merged = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (merged > 0 && entries[merged - 1].key == entries[i].key && entries[merged - 1].move == entries[i].move) {
+            totals[merged - 1] += entries[i].weight;
+        } else {
+            entries[merged++] = entries[i];
+            totals.push_back(entries[i].weight);
+        }
+    }
+    entries.resize(merged);
+
+    // Keep the ratios between a position's moves when scaling into 16 bits
+    for (size_t first = 0; first < merged; ) {
+        size_t last = first;
+        uint64_t largest = 0;
+        for (; last < merged && entries[last].key == entries[first].key; last++) {
+            largest = max(largest, totals[last]);
+        }
+        uint64_t divisor = (largest + 65534) / 65535;
+        for (size_t i = first; i < last; i++) {
+            entries[i].weight = static_cast<uint16_t>(max<uint64_t>(1, totals[i] / divisor));
+        }
+        first = last;
+    }
+
+    if (!writeBook(argv[2], entries.data(), entries.size())) {
+        cerr << "Cannot write " << argv[2] << "\n";
+        return 1;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cerr << games << " games (" << skipped << " skipped), " << entries.size() << " book entries in "
+         << seconds << "s\n";
+    return 0;
+}
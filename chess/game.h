@@ -0,0 +1,553 @@
+/**
+ * Requirements:
+ * 1. 8 * 8 chessboard
+ * 2. Each square can be empty or occupied by a piece
+ * 3. Pieces (Pawn, Rook, Knight, Bishop, Queen, King)
+ * 4. Players (White, Black)
+ * 5. Game Logic (move pieces, check for check/checkmate)
+ * 6. Game Controller (main service layer)
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "search.h"
+
+// Forward declarations
+class Piece;
+class Position;
+
+class Position {
+public:
+    int x, y;
+
+    Position() : x(0), y(0) {}
+    Position(int x, int y) : x(x), y(y) {}
+
+    bool operator==(const Position& other) const {
+        return x == other.x && y == other.y;
+    }
+};
+
+class Player {
+public:
+    std::string name;
+    Color color;
+    std::shared_ptr<SearchEngine> engine; // Set for a computer player, null for a human
+    SearchLimits limits;
+
+    Player(const std::string& name, Color color) : name(name), color(color) {}
+    Player(const std::string& name, Color color, std::shared_ptr<SearchEngine> engine, const SearchLimits& limits)
+        : name(name), color(color), engine(engine), limits(limits) {}
+};
+
+class Cell {
+public:
+    int x, y;
+    std::shared_ptr<Piece> piece;
+
+    Cell() : x(0), y(0), piece(nullptr) {}
+    Cell(int x, int y) : x(x), y(y), piece(nullptr) {}
+
+    bool isEmpty() const {
+        return piece == nullptr;
+    }
+
+    std::shared_ptr<Piece> getPiece() const {
+        return piece;
+    }
+
+    void setPiece(std::shared_ptr<Piece> p) {
+        piece = p;
+    }
+};
+
+// Object adapter over the PieceCode rules in movegen.h, for callers that want a
+// polymorphic piece API. The board itself stores plain bytes and never allocates.
+class Piece {
+public:
+    Position position;
+    Color color;
+
+    Piece(Position pos, Color c) : position(pos), color(c) {}
+    virtual ~Piece() = default;
+
+    virtual bool isValidMove(const Position& initial, const Position& final) = 0;
+    virtual char getSymbol() const = 0;
+
+protected:
+    // Movement rules on an otherwise empty board
+    bool followsRules(PieceType type, const Position& initial, const Position& final) const {
+        if (initial.x < 0 || initial.x > 7 || initial.y < 0 || initial.y > 7 ||
+            final.x < 0 || final.x > 7 || final.y < 0 || final.y > 7) {
+            return false;
+        }
+        Bitboard targets = pieceTargets(makePiece(color, type), squareIndex(initial.x, initial.y), 0, 0);
+        return (targets & squareMask(squareIndex(final.x, final.y))) != 0;
+    }
+};
+
+class King : public Piece {
+public:
+    King(const Position& pos, Color c) : Piece(pos, c) {}
+
+    bool isValidMove(const Position& initial, const Position& final) override {
+        return followsRules(PieceType::KING, initial, final);
+    }
+
+    char getSymbol() const override {
+        return (color == Color::WHITE) ? 'K' : 'k'; // Uppercase for white, lowercase for black
+    }
+};
+
+class Rook : public Piece {
+public:
+    Rook(const Position& pos, Color c) : Piece(pos, c) {}
+
+    bool isValidMove(const Position& initial, const Position& final) override {
+        return followsRules(PieceType::ROOK, initial, final);
+    }
+
+    char getSymbol() const override {
+        return (color == Color::WHITE) ? 'R' : 'r'; // Uppercase for white, lowercase for black
+    }
+};
+
+class Bishop : public Piece {
+public:
+    Bishop(const Position& pos, Color c) : Piece(pos, c) {}
+
+    bool isValidMove(const Position& initial, const Position& final) override {
+        return followsRules(PieceType::BISHOP, initial, final);
+    }
+    
+    char getSymbol() const override {
+        return (color == Color::WHITE) ? 'B' : 'b';
+    }
+};
+
+class Knight : public Piece {
+public:
+    Knight(const Position& pos, Color c) : Piece(pos, c) {}
+
+    bool isValidMove(const Position& initial, const Position& final) override {
+        return followsRules(PieceType::KNIGHT, initial, final);
+    }
+
+    char getSymbol() const override {
+        return (color == Color::WHITE) ? 'N' : 'n';
+    }
+};
+
+class Queen : public Piece {
+public:
+    Queen(const Position& position, Color color) : Piece(position, color) {}
+    
+    bool isValidMove(const Position& initial, const Position& final) override {
+        return followsRules(PieceType::QUEEN, initial, final);
+    }
+    
+    char getSymbol() const override {
+        return (color == Color::WHITE) ? 'Q' : 'q';
+    }
+};
+
+class Pawn : public Piece {
+public:
+    Pawn(const Position& position, Color color) : Piece(position, color) {}
+    
+    // Pushes only, since the board is empty; x is the rank
+    bool isValidMove(const Position& initial, const Position& final) override {
+        return followsRules(PieceType::PAWN, initial, final);
+    }
+    
+    char getSymbol() const override {
+        return (color == Color::WHITE) ? 'P' : 'p';
+    }
+};
+
+class PieceFactory {
+public:
+    static std::shared_ptr<Piece> createPiece(PieceType type, Color color, const Position& position) {
+        switch (type) {
+            case PieceType::KING:
+                return std::make_shared<King>(position, color);
+            case PieceType::QUEEN:
+                return std::make_shared<Queen>(position, color);
+            case PieceType::ROOK:
+                return std::make_shared<Rook>(position, color);
+            case PieceType::BISHOP:
+                return std::make_shared<Bishop>(position, color);
+            case PieceType::KNIGHT:
+                return std::make_shared<Knight>(position, color);
+            case PieceType::PAWN:
+                return std::make_shared<Pawn>(position, color);
+            default:
+                throw std::invalid_argument("Invalid piece type");
+        }
+    }
+};
+
+enum class GameStatus {
+    IN_PROGRESS, CHECKMATE, STALEMATE, FIFTY_MOVE_RULE, THREEFOLD_REPETITION, INSUFFICIENT_MATERIAL
+};
+
+inline const char* statusText(GameStatus status) {
+    switch (status) {
+        case GameStatus::CHECKMATE: return "Checkmate";
+        case GameStatus::STALEMATE: return "Stalemate";
+        case GameStatus::FIFTY_MOVE_RULE: return "Draw by the fifty-move rule";
+        case GameStatus::THREEFOLD_REPETITION: return "Draw by threefold repetition";
+        case GameStatus::INSUFFICIENT_MATERIAL: return "Draw by insufficient material";
+        default: return "In progress";
+    }
+}
+
+// Status of a position given how often it occurred before. Mate and
+// stalemate come first, so a mate on the hundredth quiet ply still counts.
+inline GameStatus gameStatus(const BoardState& state, int repetitions) {
+    if (!hasLegalMove(state)) {
+        return isInCheck(state, state.sideToMove) ? GameStatus::CHECKMATE : GameStatus::STALEMATE;
+    }
+    if (state.halfmoveClock >= 100) {
+        return GameStatus::FIFTY_MOVE_RULE;
+    }
+    if (repetitions >= 2) {
+        return GameStatus::THREEFOLD_REPETITION;
+    }
+    if (isInsufficientMaterial(state)) {
+        return GameStatus::INSUFFICIENT_MATERIAL;
+    }
+    return GameStatus::IN_PROGRESS;
+}
+
+class ChessBoard {
+private:
+    static const int RESERVED_HISTORY = 1024;
+    
+    BoardState state; // Primary state: bitboards, no per-square objects
+    
+    // Undo stack, so moves can be taken back without copying the board.
+    // Reserved for a long game up front; longer games grow it.
+    std::vector<Move> moveHistory;
+    std::vector<UndoInfo> undoHistory;
+    int historySize = 0;
+    
+public:
+    // Each game owns its board, so any number of games and searches can coexist
+    ChessBoard() {
+        moveHistory.reserve(RESERVED_HISTORY);
+        undoHistory.reserve(RESERVED_HISTORY);
+        initializeBoard();
+    }
+    
+    void initializeBoard() {
+        // Initialize board with starting positions
+        state.setStartPosition();
+        historySize = 0;
+    }
+    
+    // Sets up an arbitrary position; the board is left unchanged if the FEN is invalid
+    bool loadFen(const std::string& fen) {
+        BoardState loaded;
+        if (!loaded.setFromFen(fen)) {
+            return false;
+        }
+        state = loaded;
+        historySize = 0;
+        return true;
+    }
+    
+    std::string getFen() const {
+        return state.toFen();
+    }
+    
+    // Optional object view: allocates a Piece adapter for callers that want that API
+    std::shared_ptr<Piece> getPiece(const Position& position) {
+        if (position.x >= 0 && position.x < 8 && position.y >= 0 && position.y < 8) {
+            Color color;
+            PieceType type;
+            if (state.pieceAt(squareIndex(position.x, position.y), color, type)) {
+                return PieceFactory::createPiece(type, color, position);
+            }
+        }
+        return nullptr;
+    }
+    
+    Cell getCell(const Position& position) {
+        Cell cell(position.x, position.y);
+        cell.setPiece(getPiece(position));
+        return cell;
+    }
+    
+    const BoardState& getState() const {
+        return state;
+    }
+    
+    // Zobrist key of the current position, updated incrementally by makeMove
+    uint64_t getHash() const {
+        return state.hash;
+    }
+    
+    // Applies a move taken from the legal move list
+    bool makeMove(const Move& move) {
+        if (historySize == static_cast<int>(undoHistory.size())) {
+            undoHistory.emplace_back();
+            moveHistory.emplace_back();
+        }
+        state.makeMove(move, undoHistory[historySize]);
+        moveHistory[historySize++] = move;
+        return true;
+    }
+    
+    // Takes back the most recent move
+    bool unmakeMove() {
+        if (historySize == 0) {
+            return false;
+        }
+        historySize--;
+        state.unmakeMove(moveHistory[historySize], undoHistory[historySize]);
+        return true;
+    }
+    
+    int getHistorySize() const {
+        return historySize;
+    }
+    
+    // Keys of the positions before the current one since the last capture or
+    // pawn move, oldest first: what a search needs to see repetitions
+    std::vector<uint64_t> playedHashes() const {
+        std::vector<uint64_t> hashes;
+        for (int i = std::max(0, historySize - state.halfmoveClock); i < historySize; i++) {
+            hashes.push_back(undoHistory[i].hash);
+        }
+        return hashes;
+    }
+    
+    // How often the current position occurred before, read from the hashes
+    // on the undo stack. Only positions since the last capture or pawn move
+    // with the same side to move can match.
+    int repetitions() const {
+        int count = 0;
+        int oldest = historySize - state.halfmoveClock;
+        for (int i = historySize - 2; i >= 0 && i >= oldest; i -= 2) {
+            count += undoHistory[i].hash == state.hash;
+        }
+        return count;
+    }
+    
+    bool isCheck() const {
+        return isInCheck(state, state.sideToMove);
+    }
+    
+    // Whether the game has ended after the last move, and how
+    GameStatus getStatus() const {
+        return gameStatus(state, repetitions());
+    }
+    
+    void displayBoard() {
+        std::cout << "  0 1 2 3 4 5 6 7\n";
+        for (int i = 7; i >= 0; i--) {
+            std::cout << i << " ";
+            for (int j = 0; j < 8; j++) {
+                Color color;
+                PieceType type;
+                if (!state.pieceAt(squareIndex(i, j), color, type)) {
+                    std::cout << ". ";
+                } else {
+                    std::cout << pieceSymbol(color, type) << " ";
+                }
+            }
+            std::cout << "\n";
+        }
+        std::cout << "\n";
+    }
+};
+
+class Game {
+private:
+    std::shared_ptr<ChessBoard> chessboard;
+    Player player1, player2;
+    Player* currentPlayer;
+    
+public:
+    Game(const Player& p1, const Player& p2) : player1(p1), player2(p2) {
+        chessboard = std::make_shared<ChessBoard>();
+        currentPlayer = &player1;
+    }
+    
+    // Starts from a FEN position; whoever plays the side to move goes first.
+    // Throws std::invalid_argument for a malformed FEN.
+    Game(const Player& p1, const Player& p2, const std::string& fen) : Game(p1, p2) {
+        if (!chessboard->loadFen(fen)) {
+            throw std::invalid_argument("Invalid FEN: " + fen);
+        }
+        if (currentPlayer->color != chessboard->getState().sideToMove) {
+            switchTurn();
+        }
+    }
+    
+    void play() {
+        while (true) {
+            chessboard->displayBoard();
+            std::cout << "User: " << currentPlayer->name << " Turn\n";
+            
+            if (currentPlayer->engine) {
+                if (!playEngineMove()) {
+                    std::cout << "No legal moves left.\n";
+                    break;
+                }
+                if (isGameOver()) {
+                    std::cout << "Game Over! " << statusText(getStatus()) << "\n";
+                    break;
+                }
+                if (chessboard->isCheck()) {
+                    std::cout << "Check!\n";
+                }
+                switchTurn();
+                continue;
+            }
+
+            std::cout << "Enter Move (startX startY endX endY): ";
+            
+            int startX, startY, endX, endY;
+            if (!(std::cin >> startX >> startY >> endX >> endY)) {
+                break; // End of input
+            }
+            
+            Position start(startX, startY);
+            Position end(endX, endY);
+            
+            if (makeMove(start, end)) {
+                if (isGameOver()) {
+                    std::cout << "Game Over! " << statusText(getStatus()) << "\n";
+                    break;
+                }
+                if (chessboard->isCheck()) {
+                    std::cout << "Check!\n";
+                }
+                switchTurn();
+            } else {
+                std::cout << "Invalid move! Try again.\n";
+            }
+        }
+    }
+    
+    // Lets the current player's engine pick and play a move
+    bool playEngineMove() {
+        SearchResult result = currentPlayer->engine->search(chessboard->getState(), currentPlayer->limits,
+                                                            chessboard->playedHashes());
+        if (!result.hasMove) {
+            return false;
+        }
+        const Move& move = result.bestMove;
+        std::cout << "Engine plays " << move.from() / 8 << " " << move.from() % 8 << " "
+                  << move.to() / 8 << " " << move.to() % 8;
+        if (result.source == MoveSource::BOOK) {
+            std::cout << " (book)\n";
+            return chessboard->makeMove(move);
+        }
+        if (result.source == MoveSource::TABLEBASE) {
+            std::cout << " (tablebase, score " << result.score << ")\n";
+            return chessboard->makeMove(move);
+        }
+        std::cout << " (depth " << result.depth << ", score " << result.score
+                  << ", " << result.nodes << " nodes, "
+                  << static_cast<uint64_t>(result.nodesPerSecond()) << " nodes/s, "
+                  << static_cast<int>(result.tt.hitRate() * 100) << "% TT hits, "
+                  << result.tt.collisions << " TT collisions, "
+                  << result.hashfull / 10 << "% TT full)\n";
+        return chessboard->makeMove(move);
+    }
+    
+    void switchTurn() {
+        currentPlayer = (currentPlayer == &player1) ? &player2 : &player1;
+    }
+    
+    GameStatus getStatus() const {
+        return chessboard->getStatus();
+    }
+    
+    bool isGameOver() const {
+        return getStatus() != GameStatus::IN_PROGRESS;
+    }
+    
+    const ChessBoard& getBoard() const {
+        return *chessboard;
+    }
+    
+    // Plays a move given directly, e.g. one parsed from a game record. The move
+    // must be in the legal list; nothing is printed and the turn is not switched.
+    bool makeMove(const Move& move) {
+        MoveList legalMoves;
+        generateLegalMoves(chessboard->getState(), legalMoves);
+        for (const Move& legal : legalMoves) {
+            if (legal == move) {
+                return chessboard->makeMove(legal);
+            }
+        }
+        return false;
+    }
+    
+    // Takes back the last move and gives the turn back to whoever made it
+    bool undoMove() {
+        if (!chessboard->unmakeMove()) {
+            return false;
+        }
+        switchTurn();
+        return true;
+    }
+    
+    bool makeMove(const Position& from, const Position& to) {
+        // Validate bounds
+        if (from.x < 0 || from.x >= 8 || from.y < 0 || from.y >= 8 ||
+            to.x < 0 || to.x >= 8 || to.y < 0 || to.y >= 8) {
+            return false;
+        }
+        
+        const BoardState& state = chessboard->getState();
+        int fromSq = squareIndex(from.x, from.y);
+        int toSq = squareIndex(to.x, to.y);
+        
+        Color color;
+        PieceType type;
+        if (!state.pieceAt(fromSq, color, type)) {
+            std::cout << "No piece at starting position!\n";
+            return false;
+        }
+        
+        // Check if piece belongs to current player
+        if (color != currentPlayer->color) {
+            std::cout << "Not your piece!\n";
+            return false;
+        }
+        
+        // Check if destination has friendly piece
+        if (state.isOccupiedBy(toSq, currentPlayer->color)) {
+            std::cout << "Cannot capture your own piece!\n";
+            return false;
+        }
+        
+        // Check the move against the legal moves: blocking pieces, pawn captures,
+        // castling, en passant and leaving the king in check are all handled there
+        MoveList legalMoves;
+        generateLegalMoves(state, legalMoves);
+        for (const Move& move : legalMoves) {
+            // Promotions from the four-number input always choose a queen
+            if (move.from() == fromSq && move.to() == toSq &&
+                (!move.isPromotion() || move.promotion() == PieceType::QUEEN)) {
+                return chessboard->makeMove(move);
+            }
+        }
+        
+        std::cout << "Invalid move for this piece!\n";
+        return false;
+    }
+};
@@ -0,0 +1,426 @@
+/**
+ * Multi-game server: tens of thousands of independent games in one process.
+ *
+ * Games live in an arena of GameSlot records allocated once at start-up, so
+ * nothing is allocated per game or per move. A slot holds the position and
+ * the keys since the last capture or pawn move, which is all the draw rules
+ * look at, instead of ChessBoard's full undo stack: about 1 KB per game.
+ *
+ * Slot i belongs to shard i % workers, and each shard is served by exactly
+ * one worker thread, which also hands out the shard's free slots. Game state
+ * is therefore never shared between threads and takes no locks. New games
+ * are spread round-robin; a worker whose shard is full passes the request
+ * on to the next shard, and only the last one tried answers "ERR full". Connection
+ * threads only parse lines and queue them on the owning shard; a worker
+ * drains its whole queue at once and sends each connection its replies in
+ * one write.
+ *
+ * Protocol, one line per request: "<tag> <command> [arguments]", answered by
+ * "<tag> OK ..." or "<tag> ERR <reason>". Tags are picked by the client so it
+ * can pipeline; replies for games on different shards may come back in any
+ * order.
+ *   NEW [fen]         -> OK <game id>   ERR fen for a malformed or illegal position
+ *   MOVE <id> <move>  -> OK <status>      moves in coordinate form: e2e4, e7e8q
+ *   FEN <id>          -> OK <fen>
+ *   END <id>          -> OK               frees the slot
+ *   STATS             -> OK <games> <moves>
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "game.h"
+#include "local_socket.h"
+
+// One-word status names used on the wire
+inline const char* statusToken(GameStatus status) {
+    switch (status) {
+        case GameStatus::CHECKMATE: return "checkmate";
+        case GameStatus::STALEMATE: return "stalemate";
+        case GameStatus::FIFTY_MOVE_RULE: return "fifty";
+        case GameStatus::THREEFOLD_REPETITION: return "repetition";
+        case GameStatus::INSUFFICIENT_MATERIAL: return "material";
+        default: return "ongoing";
+    }
+}
+
+// Coordinate notation: from and to squares, plus the promotion piece
+inline std::string moveText(const Move& move) {
+    std::string text;
+    text += static_cast<char>('a' + move.from() % 8);
+    text += static_cast<char>('1' + move.from() / 8);
+    text += static_cast<char>('a' + move.to() % 8);
+    text += static_cast<char>('1' + move.to() / 8);
+    if (move.isPromotion()) {
+        text += pieceSymbol(Color::BLACK, move.promotion());
+    }
+    return text;
+}
+
+// Finds the legal move written in coordinate notation
+inline bool parseMoveText(const BoardState& state, const char* text, Move& move) {
+    MoveList moves;
+    generateLegalMoves(state, moves);
+    for (const Move& candidate : moves) {
+        if (moveText(candidate) == text) {
+            move = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// One hosted game. Keys only need to reach back to the last irreversible
+// move, and the game is drawn by the time that is 100 plies ago.
+struct GameSlot {
+    static const int KEY_WINDOW = 101;
+
+    BoardState state;
+    uint64_t keys[KEY_WINDOW]; // Positions since the last capture or pawn move, current last
+    int keyCount = 0;
+    uint32_t generation = 0;   // Bumped when the slot is freed, so stale ids are refused
+    bool active = false;
+    GameStatus status = GameStatus::IN_PROGRESS;
+
+    void start(const BoardState& position) {
+        state = position;
+        keys[0] = state.hash;
+        keyCount = 1;
+        active = true;
+        status = gameStatus(state, 0);
+    }
+
+    void play(const Move& move) {
+        UndoInfo undo;
+        state.makeMove(move, undo);
+        if (state.halfmoveClock == 0 || keyCount == KEY_WINDOW) {
+            keyCount = 0;
+        }
+        keys[keyCount++] = state.hash;
+        status = gameStatus(state, repetitions());
+    }
+
+    int repetitions() const {
+        int count = 0;
+        for (int i = keyCount - 3; i >= 0; i -= 2) {
+            count += keys[i] == state.hash;
+        }
+        return count;
+    }
+};
+
+// A client connection; workers on any shard may reply on it
+class ServerConnection {
+public:
+    explicit ServerConnection(SocketHandle socket) : socket(socket) {}
+
+    ~ServerConnection() {
+        closeSocket(socket);
+    }
+
+    ServerConnection(const ServerConnection&) = delete;
+    ServerConnection& operator=(const ServerConnection&) = delete;
+
+    void send(const std::string& text) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        sendAll(socket, text.data(), text.size());
+    }
+
+    SocketHandle handle() const {
+        return socket;
+    }
+
+private:
+    SocketHandle socket;
+    std::mutex writeMutex;
+};
+
+class GameServer {
+public:
+    enum class Command { NEW, MOVE, FEN, END };
+
+    struct Request {
+        std::shared_ptr<ServerConnection> connection;
+        std::string tag;
+        Command command;
+        uint64_t game;
+        std::string argument; // Move or FEN
+        size_t refusals;      // Full shards a NEW request has passed through
+    };
+
+    GameServer(int workers, int capacity)
+        : slots(static_cast<size_t>(capacity)) {
+        if (workers < 1) {
+            workers = 1;
+        }
+        for (int i = 0; i < workers; i++) {
+            shards.emplace_back(new Shard());
+            shards.back()->index = static_cast<size_t>(i);
+        }
+        for (int slot = capacity - 1; slot >= 0; slot--) {
+            shards[slot % workers]->freeSlots.push_back(static_cast<uint32_t>(slot));
+        }
+        for (int i = 0; i < workers; i++) {
+            threads.emplace_back([this, i] { runShard(*shards[i]); });
+        }
+    }
+
+    ~GameServer() {
+        for (auto& shard : shards) {
+            {
+                std::lock_guard<std::mutex> lock(shard->mutex);
+                shard->stopping = true;
+            }
+            shard->ready.notify_one();
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    }
+
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    int capacity() const {
+        return static_cast<int>(slots.size());
+    }
+
+    // Accepts clients on 127.0.0.1:port, one reader thread per connection.
+    // Only returns if the port cannot be opened.
+    bool serve(int port) {
+        if (!socketStartup()) {
+            return false;
+        }
+        SocketHandle listener = listenLocal(port);
+        if (listener == NO_SOCKET) {
+            return false;
+        }
+        while (true) {
+            SocketHandle client = acceptClient(listener);
+            if (client == NO_SOCKET) {
+                continue;
+            }
+            auto connection = std::make_shared<ServerConnection>(client);
+            std::thread([this, connection] { readRequests(connection); }).detach();
+        }
+    }
+
+    // Parses one request line and queues it on the shard that owns the game.
+    // Malformed lines are answered straight away.
+    void submit(const std::shared_ptr<ServerConnection>& connection, const char* line, size_t& nextShard) {
+        char command[8] = {};
+        char tag[32] = {};
+        int consumed = static_cast<int>(strlen(line));
+        if (sscanf(line, "%31s %7s %n", tag, command, &consumed) < 2) {
+            connection->send(std::string(tag[0] ? tag : "?") + " ERR syntax\n");
+            return;
+        }
+        const char* rest = line + consumed;
+        Request request{ connection, tag, Command::NEW, 0, {}, 0 };
+        if (strcmp(command, "STATS") == 0) {
+            connection->send(request.tag + " OK " + std::to_string(activeGames.load()) + " " +
+                             std::to_string(movesPlayed.load()) + "\n");
+            return;
+        }
+        size_t shard;
+        if (strcmp(command, "NEW") == 0) {
+            request.argument = rest;
+            shard = nextShard++ % shards.size();
+        } else {
+            char* end;
+            request.game = strtoull(rest, &end, 10);
+            if (end == rest) {
+                connection->send(request.tag + " ERR syntax\n");
+                return;
+            }
+            while (*end == ' ') end++;
+            request.argument = end;
+            if (strcmp(command, "MOVE") == 0) request.command = Command::MOVE;
+            else if (strcmp(command, "FEN") == 0) request.command = Command::FEN;
+            else if (strcmp(command, "END") == 0) request.command = Command::END;
+            else {
+                connection->send(request.tag + " ERR command\n");
+                return;
+            }
+            shard = slotOf(request.game) % shards.size();
+        }
+        enqueue(*shards[shard], std::move(request));
+    }
+
+private:
+    struct Shard {
+        size_t index;
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::vector<Request> queue;
+        bool stopping = false;
+        std::vector<uint32_t> freeSlots; // Only touched by the shard's worker
+    };
+
+    std::vector<GameSlot> slots;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<std::thread> threads;
+    std::atomic<int> activeGames{ 0 };
+    std::atomic<uint64_t> movesPlayed{ 0 };
+
+    static uint32_t slotOf(uint64_t game) {
+        return static_cast<uint32_t>(game);
+    }
+
+    void enqueue(Shard& target, Request&& request) {
+        bool wasEmpty;
+        {
+            std::lock_guard<std::mutex> lock(target.mutex);
+            wasEmpty = target.queue.empty();
+            target.queue.push_back(std::move(request));
+        }
+        if (wasEmpty) {
+            target.ready.notify_one();
+        }
+    }
+
+    void readRequests(std::shared_ptr<ServerConnection> connection) {
+        std::vector<char> buffer(1 << 16);
+        size_t filled = 0;
+        size_t nextShard = 0; // New games are spread round-robin
+        while (true) {
+            if (filled == buffer.size()) {
+                buffer.resize(buffer.size() * 2); // A line longer than the buffer
+            }
+            int got = receive(connection->handle(), buffer.data() + filled, buffer.size() - filled);
+            if (got <= 0) {
+                return;
+            }
+            filled += static_cast<size_t>(got);
+            size_t start = 0;
+            for (size_t i = filled - got; i < filled; i++) {
+                if (buffer[i] == '\n') {
+                    buffer[i] = '\0';
+                    if (i > start && buffer[i - 1] == '\r') buffer[i - 1] = '\0';
+                    submit(connection, buffer.data() + start, nextShard);
+                    start = i + 1;
+                }
+            }
+            memmove(buffer.data(), buffer.data() + start, filled - start);
+            filled -= start;
+        }
+    }
+
+    void runShard(Shard& shard) {
+        std::vector<Request> batch;
+        std::vector<std::pair<ServerConnection*, std::string>> replies;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(shard.mutex);
+                shard.ready.wait(lock, [&] { return shard.stopping || !shard.queue.empty(); });
+                if (shard.queue.empty()) {
+                    return;
+                }
+                batch.swap(shard.queue);
+            }
+            for (Request& request : batch) {
+                // Another shard may still have room; answered there
+                if (request.command == Command::NEW && shard.freeSlots.empty() &&
+                    request.refusals + 1 < shards.size()) {
+                    request.refusals++;
+                    enqueue(*shards[(shard.index + 1) % shards.size()], std::move(request));
+                    continue;
+                }
+                std::string* out = nullptr;
+                for (auto& reply : replies) {
+                    if (reply.first == request.connection.get()) out = &reply.second;
+                }
+                if (out == nullptr) {
+                    replies.emplace_back(request.connection.get(), std::string());
+                    out = &replies.back().second;
+                }
+                *out += request.tag;
+                handle(shard, request, *out);
+                *out += '\n';
+            }
+            // Connections stay alive until the batch holding their requests is cleared
+            for (auto& reply : replies) {
+                reply.first->send(reply.second);
+            }
+            replies.clear();
+            batch.clear();
+        }
+    }
+
+    GameSlot* find(uint64_t game) {
+        uint32_t slot = slotOf(game);
+        if (slot >= slots.size() || !slots[slot].active || slots[slot].generation != (game >> 32)) {
+            return nullptr;
+        }
+        return &slots[slot];
+    }
+
+    void handle(Shard& shard, const Request& request, std::string& out) {
+        if (request.command == Command::NEW) {
+            BoardState position;
+            if (request.argument.empty()) {
+                position.setStartPosition();
+            } else if (!position.setFromFen(request.argument)) {
+                // Includes positions move generation cannot handle, such as
+                // a capturable king or a bogus en-passant square
+                out += " ERR fen";
+                return;
+            }
+            if (shard.freeSlots.empty()) {
+                out += " ERR full";
+                return;
+            }
+            uint32_t slot = shard.freeSlots.back();
+            shard.freeSlots.pop_back();
+            slots[slot].start(position);
+            activeGames++;
+            out += " OK " + std::to_string((static_cast<uint64_t>(slots[slot].generation) << 32) | slot);
+            return;
+        }
+        GameSlot* game = find(request.game);
+        if (game == nullptr) {
+            out += " ERR game";
+            return;
+        }
+        switch (request.command) {
+            case Command::MOVE: {
+                Move move;
+                if (game->status != GameStatus::IN_PROGRESS) {
+                    out += " ERR over";
+                } else if (!parseMoveText(game->state, request.argument.c_str(), move)) {
+                    out += " ERR illegal";
+                } else {
+                    game->play(move);
+                    movesPlayed.fetch_add(1, std::memory_order_relaxed);
+                    out += " OK ";
+                    out += statusToken(game->status);
+                }
+                break;
+            }
+            case Command::FEN:
+                out += " OK " + game->state.toFen();
+                break;
+            case Command::END:
+                game->active = false;
+                game->generation++;
+                shard.freeSlots.push_back(slotOf(request.game));
+                activeGames--;
+                out += " OK";
+                break;
+            default:
+                break;
+        }
+    }
+};
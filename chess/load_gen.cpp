@@ -0,0 +1,276 @@
+/**
+ * Load generator for the game server (chess --serve, see game_server.h).
+ *
+ * Opens a number of connections, starts the games on them and then sends
+ * random legal moves at a fixed rate, open loop: requests go out on a
+ * schedule whether or not earlier replies have arrived, and latency counts
+ * from the scheduled time, so a stalled server shows up in the tail instead
+ * of slowing the load down. Each game has at most one move in flight; the
+ * client keeps its own copy of every position to pick moves from. Finished
+ * games are ended and replaced by new ones.
+ *
+ * Usage: load_gen [port] [moves/s] [seconds] [games] [connections]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "game_server.h"
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+// Tags carry the game index and what the request was
+enum RequestKind { KIND_MOVE = 0, KIND_NEW = 1, KIND_END = 2 };
+
+struct ClientGame {
+    BoardState state;
+    uint64_t id = 0;
+    Move pending;
+    Clock::time_point scheduled;
+    atomic<bool> busy{ false }; // A request is in flight
+};
+
+struct Client {
+    SocketHandle socket = NO_SOCKET;
+    mutex writeMutex;
+    vector<ClientGame> games;
+    vector<uint32_t> latencies; // Microseconds, written by the receiver only
+    uint64_t sent = 0, skipped = 0;
+    uint64_t rejected = 0, finished = 0;
+
+    explicit Client(size_t gameCount) : games(gameCount) {}
+
+    void send(const string& text) {
+        lock_guard<mutex> lock(writeMutex);
+        sendAll(socket, text.data(), text.size());
+    }
+
+    static string tag(size_t game, RequestKind kind) {
+        return to_string(game * 4 + kind);
+    }
+
+    // Reads replies until the server closes the connection
+    void receive() {
+        vector<char> buffer(1 << 16);
+        size_t filled = 0;
+        while (true) {
+            int got = ::receive(socket, buffer.data() + filled, buffer.size() - filled);
+            if (got <= 0) {
+                return;
+            }
+            filled += static_cast<size_t>(got);
+            size_t start = 0;
+            for (size_t i = filled - got; i < filled; i++) {
+                if (buffer[i] == '\n') {
+                    buffer[i] = '\0';
+                    reply(buffer.data() + start);
+                    start = i + 1;
+                }
+            }
+            memmove(buffer.data(), buffer.data() + start, filled - start);
+            filled -= start;
+        }
+    }
+
+    void reply(const char* line) {
+        char* rest;
+        uint64_t tagValue = strtoull(line, &rest, 10);
+        size_t index = tagValue / 4;
+        if (index >= games.size()) {
+            return;
+        }
+        ClientGame& game = games[index];
+        bool ok = strncmp(rest, " OK", 3) == 0;
+        const char* value = rest + (ok ? 4 : 0);
+        switch (static_cast<RequestKind>(tagValue % 4)) {
+            case KIND_NEW:
+                game.id = strtoull(value, nullptr, 10);
+                game.state.setStartPosition();
+                game.busy.store(false, memory_order_release);
+                break;
+            case KIND_MOVE: {
+                game.busy.load(memory_order_acquire); // Pairs with the sender publishing the move
+                auto latency = chrono::duration_cast<chrono::microseconds>(Clock::now() - game.scheduled);
+                latencies.push_back(static_cast<uint32_t>(latency.count()));
+                if (!ok) {
+                    rejected++;
+                    game.busy.store(false, memory_order_release);
+                    break;
+                }
+                UndoInfo undo;
+                game.state.makeMove(game.pending, undo);
+                if (strcmp(value, "ongoing") != 0) {
+                    finished++; // Replace the game; it stays busy until the new one starts
+                    send(tag(index, KIND_END) + " END " + to_string(game.id) + "\n" + tag(index, KIND_NEW) + " NEW\n");
+                    break;
+                }
+                game.busy.store(false, memory_order_release);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    // Sends moves at `rate` per second until `end`, always to the next idle game
+    void sendMoves(double rate, Clock::time_point end, uint64_t seed) {
+        auto interval = chrono::duration_cast<Clock::duration>(chrono::duration<double>(1.0 / rate));
+        Clock::time_point next = Clock::now();
+        size_t cursor = 0;
+        string out;
+        MoveList moves;
+        while (next < end) {
+            this_thread::sleep_until(next);
+            Clock::time_point now = Clock::now();
+            out.clear();
+            for (; next <= now && next < end; next += interval) {
+                ClientGame* game = nullptr;
+                size_t index = 0;
+                for (size_t k = 0; k < games.size() && game == nullptr; k++) {
+                    index = cursor++ % games.size();
+                    if (!games[index].busy.load(memory_order_acquire)) {
+                        game = &games[index];
+                    }
+                }
+                if (game == nullptr) {
+                    skipped++; // Every game is waiting for a reply
+                    continue;
+                }
+                generateLegalMoves(game->state, moves);
+                seed ^= seed << 13;
+                seed ^= seed >> 7;
+                seed ^= seed << 17;
+                game->pending = moves[static_cast<int>(seed % moves.size())];
+                game->scheduled = next;
+                game->busy.store(true, memory_order_release);
+                out += tag(index, KIND_MOVE) + " MOVE " + to_string(game->id) + " " + moveText(game->pending) + "\n";
+                sent++;
+            }
+            if (!out.empty()) {
+                send(out);
+            }
+        }
+    }
+
+    bool idle() const {
+        for (const ClientGame& game : games) {
+            if (game.busy.load(memory_order_acquire)) return false;
+        }
+        return true;
+    }
+};
+
+static uint32_t percentile(vector<uint32_t>& values, double fraction) {
+    if (values.empty()) {
+        return 0;
+    }
+    size_t rank = min(values.size() - 1, static_cast<size_t>(fraction * values.size()));
+    nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+int main(int argc, char* argv[]) {
+    int port = (argc > 1) ? atoi(argv[1]) : 7070;
+    double rate = (argc > 2) ? atof(argv[2]) : 20000;
+    double seconds = (argc > 3) ? atof(argv[3]) : 10;
+    int gameCount = (argc > 4) ? atoi(argv[4]) : 10000;
+    int connections = (argc > 5) ? atoi(argv[5]) : 4;
+    if (!socketStartup()) {
+        return 1;
+    }
+
+    vector<unique_ptr<Client>> clients;
+    vector<thread> receivers;
+    for (int c = 0; c < connections; c++) {
+        clients.emplace_back(new Client(gameCount / connections + (c < gameCount % connections ? 1 : 0)));
+        clients[c]->socket = connectLocal(port);
+        if (clients[c]->socket == NO_SOCKET) {
+            cerr << "Cannot connect to 127.0.0.1:" << port << "\n";
+            return 1;
+        }
+    }
+    for (int c = 0; c < connections; c++) {
+        receivers.emplace_back([&clients, c] { clients[c]->receive(); });
+    }
+
+    // Start every game, pipelined
+    auto setupStart = Clock::now();
+    for (auto& client : clients) {
+        string out;
+        for (size_t i = 0; i < client->games.size(); i++) {
+            client->games[i].busy = true;
+            out += Client::tag(i, KIND_NEW) + " NEW\n";
+        }
+        client->send(out);
+    }
+    for (auto& client : clients) {
+        while (!client->idle()) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+    }
+    double setupSeconds = chrono::duration<double>(Clock::now() - setupStart).count();
+
+    auto start = Clock::now();
+    auto end = start + chrono::duration_cast<Clock::duration>(chrono::duration<double>(seconds));
+    vector<thread> senders;
+    for (int c = 0; c < connections; c++) {
+        senders.emplace_back([&clients, c, rate, connections, end] {
+            clients[c]->sendMoves(rate / connections, end, 0x9E3779B97F4A7C15ULL + c);
+        });
+    }
+    for (thread& t : senders) {
+        t.join();
+    }
+
+    // Let outstanding replies arrive, then free the games and hang up
+    auto drainLimit = Clock::now() + chrono::seconds(5);
+    for (auto& client : clients) {
+        while (!client->idle() && Clock::now() < drainLimit) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+    }
+    double elapsed = chrono::duration<double>(Clock::now() - start).count();
+    for (auto& client : clients) {
+        string out;
+        for (size_t i = 0; i < client->games.size(); i++) {
+            out += Client::tag(i, KIND_END) + " END " + to_string(client->games[i].id) + "\n";
+        }
+        client->send(out);
+        finishSending(client->socket);
+    }
+    for (thread& t : receivers) {
+        t.join();
+    }
+
+    vector<uint32_t> latencies;
+    uint64_t sent = 0, skipped = 0, rejected = 0, finished = 0;
+    for (auto& client : clients) {
+        latencies.insert(latencies.end(), client->latencies.begin(), client->latencies.end());
+        sent += client->sent;
+        skipped += client->skipped;
+        rejected += client->rejected;
+        finished += client->finished;
+        closeSocket(client->socket);
+    }
+
+    cout << connections << " connections, " << gameCount << " games started in " << fixed << setprecision(2)
+         << setupSeconds << "s, target " << setprecision(0) << rate << " moves/s for " << seconds << "s\n";
+    cout << "  moves sent " << sent << ", answered " << latencies.size() << ", rejected " << rejected
+         << ", games finished " << finished << ", no idle game " << skipped << " times\n";
+    cout << "  achieved " << latencies.size() / elapsed << " moves/s\n";
+    uint32_t maximum = latencies.empty() ? 0 : *max_element(latencies.begin(), latencies.end());
+    cout << "  latency p50 " << percentile(latencies, 0.50) << " us, p90 " << percentile(latencies, 0.90)
+         << " us, p99 " << percentile(latencies, 0.99) << " us, p99.9 " << percentile(latencies, 0.999)
+         << " us, max " << maximum << " us\n";
+    return 0;
+}
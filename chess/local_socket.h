@@ -0,0 +1,136 @@
+/**
+ * Loopback TCP sockets (POSIX sockets or Winsock) for the game server and
+ * its load generator. Listening sockets bind to 127.0.0.1 only.
+ *
+ * On Windows link with -lws2_32.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+using SocketHandle = SOCKET;
+const SocketHandle NO_SOCKET = INVALID_SOCKET;
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+using SocketHandle = int;
+const SocketHandle NO_SOCKET = -1;
+#endif
+
+// Must run once before any other call; a no-op outside Windows
+inline bool socketStartup() {
+#ifdef _WIN32
+    WSADATA data;
+    return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+#else
+    return true;
+#endif
+}
+
+inline void closeSocket(SocketHandle socket) {
+#ifdef _WIN32
+    closesocket(socket);
+#else
+    close(socket);
+#endif
+}
+
+// Wakes a thread blocked in receive() on the same socket
+inline void shutdownSocket(SocketHandle socket) {
+#ifdef _WIN32
+    shutdown(socket, SD_BOTH);
+#else
+    shutdown(socket, SHUT_RDWR);
+#endif
+}
+
+// Tells the peer no more requests follow; replies can still be read
+inline void finishSending(SocketHandle socket) {
+#ifdef _WIN32
+    shutdown(socket, SD_SEND);
+#else
+    shutdown(socket, SHUT_WR);
+#endif
+}
+
+// Small request/reply lines must not wait for Nagle's algorithm
+inline void setNoDelay(SocketHandle socket) {
+    int on = 1;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&on), sizeof(on));
+}
+
+inline sockaddr_in loopbackAddress(int port) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<unsigned short>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return address;
+}
+
+inline SocketHandle listenLocal(int port) {
+    SocketHandle server = socket(AF_INET, SOCK_STREAM, 0);
+    if (server == NO_SOCKET) {
+        return NO_SOCKET;
+    }
+    int on = 1;
+    setsockopt(server, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&on), sizeof(on));
+    sockaddr_in address = loopbackAddress(port);
+    if (bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(server, 64) != 0) {
+        closeSocket(server);
+        return NO_SOCKET;
+    }
+    return server;
+}
+
+inline SocketHandle acceptClient(SocketHandle server) {
+    SocketHandle client = accept(server, nullptr, nullptr);
+    if (client != NO_SOCKET) {
+        setNoDelay(client);
+    }
+    return client;
+}
+
+inline SocketHandle connectLocal(int port) {
+    SocketHandle client = socket(AF_INET, SOCK_STREAM, 0);
+    if (client == NO_SOCKET) {
+        return NO_SOCKET;
+    }
+    sockaddr_in address = loopbackAddress(port);
+    if (connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        closeSocket(client);
+        return NO_SOCKET;
+    }
+    setNoDelay(client);
+    return client;
+}
+
+// Sends the whole buffer; false once the peer has gone away
+inline bool sendAll(SocketHandle socket, const char* data, size_t size) {
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL; // A closed peer must not raise SIGPIPE
+#else
+    const int flags = 0;
+#endif
+    while (size > 0) {
+        int chunk = size > (1u << 30) ? (1 << 30) : static_cast<int>(size);
+        int sent = static_cast<int>(send(socket, data, chunk, flags));
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+// Bytes read, 0 at end of stream, negative on error
+inline int receive(SocketHandle socket, char* buffer, size_t capacity) {
+    return static_cast<int>(recv(socket, buffer, static_cast<int>(capacity), 0));
+}
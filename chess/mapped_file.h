@@ -0,0 +1,166 @@
+/**
+ * Read-only memory-mapped files (POSIX mmap or Windows file mappings).
+ *
+ * Used both for streaming large archives window by window (pgn.h) and for
+ * random-access lookup tables mapped whole (book.h, tablebase.h).
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// One mapped window of a file; unmapped when the last reference goes away
+class MappedRegion {
+public:
+    const char* data = nullptr; // First requested byte
+    size_t size = 0;
+
+    MappedRegion(void* base, size_t mappedLength, size_t skip, size_t size)
+        : data(static_cast<const char*>(base) + skip), size(size), base(base), mappedLength(mappedLength) {}
+
+    ~MappedRegion() {
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+#else
+        munmap(base, mappedLength);
+#endif
+    }
+
+    MappedRegion(const MappedRegion&) = delete;
+    MappedRegion& operator=(const MappedRegion&) = delete;
+
+private:
+    void* base;
+    size_t mappedLength;
+};
+
+// Owns the open file; regions it mapped stay valid after it is closed
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    ~MappedFile() {
+        close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // The moved-from file is left closed
+    MappedFile(MappedFile&& other) noexcept {
+        swap(other);
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            swap(other);
+        }
+        return *this;
+    }
+
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER length;
+        GetFileSizeEx(file, &length);
+        fileSize = static_cast<uint64_t>(length.QuadPart);
+        mapping = fileSize ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        granularity = info.dwAllocationGranularity;
+        return fileSize == 0 || mapping != nullptr;
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close();
+            return false;
+        }
+        fileSize = static_cast<uint64_t>(st.st_size);
+        granularity = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        return true;
+#endif
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+    }
+
+    uint64_t size() const {
+        return fileSize;
+    }
+
+    // Maps bytes [offset, offset + length); the OS needs an aligned start, so
+    // a few bytes before `offset` may be mapped and skipped. Pages are shared
+    // read-only with every other process mapping the same file.
+    std::shared_ptr<MappedRegion> map(uint64_t offset, size_t length, bool sequential = true) const {
+        uint64_t alignedOffset = offset - offset % granularity;
+        size_t skip = static_cast<size_t>(offset - alignedOffset);
+        size_t mappedLength = length + skip;
+#ifdef _WIN32
+        void* base = MapViewOfFile(mapping, FILE_MAP_READ, static_cast<DWORD>(alignedOffset >> 32),
+                                   static_cast<DWORD>(alignedOffset & 0xFFFFFFFF), mappedLength);
+        if (base == nullptr) {
+            return nullptr;
+        }
+#else
+        void* base = mmap(nullptr, mappedLength, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(alignedOffset));
+        if (base == MAP_FAILED) {
+            return nullptr;
+        }
+        // Streams read ahead and drop pages behind; lookups only fault in what they touch
+        madvise(base, mappedLength, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+#endif
+        return std::make_shared<MappedRegion>(base, mappedLength, skip, length);
+    }
+
+private:
+    void swap(MappedFile& other) noexcept {
+        std::swap(fileSize, other.fileSize);
+        std::swap(granularity, other.granularity);
+#ifdef _WIN32
+        std::swap(file, other.file);
+        std::swap(mapping, other.mapping);
+#else
+        std::swap(fd, other.fd);
+#endif
+    }
+
+    uint64_t fileSize = 0;
+    uint64_t granularity = 4096;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
@@ -0,0 +1,341 @@
+/**
+ * Legal move generation over BoardState.
+ *
+ * Moves are written into a fixed-capacity MoveList (no heap allocation).
+ * Pseudo-legal moves cover pawn pushes and captures, promotions, en passant
+ * and castling; the legal filter then drops any move that leaves the mover's
+ * king attacked.
+ */
+
+#pragma once
+
+#include "attacks.h"
+
+// 218 is the most legal moves known for any position
+const int MAX_MOVES = 256;
+
+struct MoveList {
+    Move moves[MAX_MOVES];
+    int count = 0;
+
+    void add(const Move& move) {
+        moves[count++] = move;
+    }
+
+    int size() const { return count; }
+    Move* begin() { return moves; }
+    Move* end() { return moves + count; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + count; }
+    Move& operator[](int i) { return moves[i]; }
+    const Move& operator[](int i) const { return moves[i]; }
+};
+
+inline bool isSquareAttacked(const BoardState& state, int square, Color by) {
+    Bitboard queens = state.piecesOf(by, PieceType::QUEEN);
+    return (pawnAttacks(opposite(by), square) & state.piecesOf(by, PieceType::PAWN)) ||
+           (knightAttacks(square) & state.piecesOf(by, PieceType::KNIGHT)) ||
+           (kingAttacks(square) & state.piecesOf(by, PieceType::KING)) ||
+           (rookAttacks(square, state.occupied) & (state.piecesOf(by, PieceType::ROOK) | queens)) ||
+           (bishopAttacks(square, state.occupied) & (state.piecesOf(by, PieceType::BISHOP) | queens));
+}
+
+inline bool isInCheck(const BoardState& state, Color c) {
+    return isSquareAttacked(state, state.kingSquare(c), opposite(c));
+}
+
+inline void addPawnMove(MoveList& list, int from, int to, int flags, bool promotes) {
+    if (promotes) {
+        static const PieceType promotions[4] = {
+            PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT
+        };
+        for (PieceType p : promotions) {
+            list.add(Move(from, to, flags | MOVE_PROMOTION, p));
+        }
+    } else {
+        list.add(Move(from, to, flags));
+    }
+}
+
+inline void addTargets(MoveList& list, int from, Bitboard targets, Bitboard enemy) {
+    while (targets) {
+        int to = popLsb(targets);
+        list.add(Move(from, to, (enemy & squareMask(to)) ? MOVE_CAPTURE : MOVE_QUIET));
+    }
+}
+
+// Squares a piece standing on `from` may move to, dispatched on its PieceCode:
+// pushes and captures for pawns, attack sets minus own pieces for the rest.
+// Castling is left to the generator.
+inline Bitboard pieceTargets(PieceCode piece, int from, Bitboard own, Bitboard enemy, int enPassant = -1) {
+    Bitboard occupied = own | enemy;
+    switch (pieceType(piece)) {
+        case PieceType::PAWN: {
+            Color c = pieceColor(piece);
+            int forward = (c == Color::WHITE) ? 8 : -8;
+            int startRank = (c == Color::WHITE) ? 1 : 6;
+            Bitboard targets = pawnAttacks(c, from) & (enemy | (enPassant >= 0 ? squareMask(enPassant) : 0));
+            int to = from + forward;
+            if (to >= 0 && to < 64 && !(occupied & squareMask(to))) {
+                targets |= squareMask(to);
+                if (from / 8 == startRank && !(occupied & squareMask(to + forward))) {
+                    targets |= squareMask(to + forward);
+                }
+            }
+            return targets;
+        }
+        case PieceType::KNIGHT: return knightAttacks(from) & ~own;
+        case PieceType::BISHOP: return bishopAttacks(from, occupied) & ~own;
+        case PieceType::ROOK: return rookAttacks(from, occupied) & ~own;
+        case PieceType::QUEEN: return queenAttacks(from, occupied) & ~own;
+        case PieceType::KING: return kingAttacks(from) & ~own;
+    }
+    return 0;
+}
+
+// Whether the piece on `from` obeys its movement rules going to `to` (blocking
+// included, king safety not)
+inline bool isPseudoLegalTarget(const BoardState& state, int from, int to) {
+    PieceCode piece = state.pieceOn(from);
+    if (piece == NO_PIECE) {
+        return false;
+    }
+    int c = colorIndex(pieceColor(piece));
+    return (pieceTargets(piece, from, state.occupancy[c], state.occupancy[c ^ 1], state.enPassant) &
+            squareMask(to)) != 0;
+}
+
+// Moves that obey piece geometry and blocking but may leave the king in check
+inline void generatePseudoLegalMoves(const BoardState& state, MoveList& list) {
+    Color us = state.sideToMove;
+    Color them = opposite(us);
+    Bitboard own = state.occupancy[colorIndex(us)];
+    Bitboard enemy = state.occupancy[colorIndex(them)];
+    Bitboard empty = ~state.occupied;
+
+    // Pawns
+    int forward = (us == Color::WHITE) ? 8 : -8;
+    int startRank = (us == Color::WHITE) ? 1 : 6;
+    int lastRank = (us == Color::WHITE) ? 7 : 0;
+    Bitboard pawns = state.piecesOf(us, PieceType::PAWN);
+    while (pawns) {
+        int from = popLsb(pawns);
+        int to = from + forward;
+        bool promotes = (to / 8) == lastRank;
+        if (empty & squareMask(to)) {
+            addPawnMove(list, from, to, MOVE_QUIET, promotes);
+            if (from / 8 == startRank && (empty & squareMask(to + forward))) {
+                list.add(Move(from, to + forward, MOVE_DOUBLE_PUSH));
+            }
+        }
+        Bitboard captures = pawnAttacks(us, from) & enemy;
+        while (captures) {
+            addPawnMove(list, from, popLsb(captures), MOVE_CAPTURE, promotes);
+        }
+        if (state.enPassant >= 0 && (pawnAttacks(us, from) & squareMask(state.enPassant))) {
+            list.add(Move(from, state.enPassant, MOVE_CAPTURE | MOVE_EN_PASSANT));
+        }
+    }
+
+    // Knights
+    Bitboard knights = state.piecesOf(us, PieceType::KNIGHT);
+    while (knights) {
+        int from = popLsb(knights);
+        addTargets(list, from, knightAttacks(from) & ~own, enemy);
+    }
+
+    // Sliders
+    Bitboard diagonal = state.piecesOf(us, PieceType::BISHOP) | state.piecesOf(us, PieceType::QUEEN);
+    while (diagonal) {
+        int from = popLsb(diagonal);
+        addTargets(list, from, bishopAttacks(from, state.occupied) & ~own, enemy);
+    }
+    Bitboard straight = state.piecesOf(us, PieceType::ROOK) | state.piecesOf(us, PieceType::QUEEN);
+    while (straight) {
+        int from = popLsb(straight);
+        addTargets(list, from, rookAttacks(from, state.occupied) & ~own, enemy);
+    }
+
+    // King
+    int king = state.kingSquare(us);
+    addTargets(list, king, kingAttacks(king) & ~own, enemy);
+
+    // Castling: path empty, king not in check and not passing through an attacked square.
+    // The landing square is checked by the legal filter.
+    int kingside = (us == Color::WHITE) ? WHITE_KINGSIDE : BLACK_KINGSIDE;
+    int queenside = (us == Color::WHITE) ? WHITE_QUEENSIDE : BLACK_QUEENSIDE;
+    int homeKing = (us == Color::WHITE) ? squareIndex(0, 4) : squareIndex(7, 4);
+    Bitboard rooks = state.piecesOf(us, PieceType::ROOK);
+    if ((state.castlingRights & (kingside | queenside)) && king == homeKing &&
+        !isSquareAttacked(state, king, them)) {
+        if ((state.castlingRights & kingside) && (rooks & squareMask(king + 3)) &&
+            (state.isEmpty(king + 1) && state.isEmpty(king + 2)) &&
+            !isSquareAttacked(state, king + 1, them)) {
+            list.add(Move(king, king + 2, MOVE_CASTLING));
+        }
+        if ((state.castlingRights & queenside) && (rooks & squareMask(king - 4)) &&
+            (state.isEmpty(king - 1) && state.isEmpty(king - 2) && state.isEmpty(king - 3)) &&
+            !isSquareAttacked(state, king - 1, them)) {
+            list.add(Move(king, king - 2, MOVE_CASTLING));
+        }
+    }
+}
+
+inline void generateLegalMoves(const BoardState& state, MoveList& list) {
+    MoveList pseudo;
+    generatePseudoLegalMoves(state, pseudo);
+
+    // One scratch copy per call; each candidate is tried with make/unmake
+    BoardState scratch = state;
+    Color us = state.sideToMove;
+    list.count = 0;
+    for (const Move& move : pseudo) {
+        UndoInfo undo;
+        scratch.makeMove(move, undo);
+        if (!isInCheck(scratch, us)) {
+            list.add(move);
+        }
+        scratch.unmakeMove(move, undo);
+    }
+}
+
+// Every piece of either color that attacks `square`, with sliders blocked by `occupied`
+inline Bitboard attackersTo(const BoardState& state, int square, Bitboard occupied) {
+    Bitboard queens = state.piecesOf(Color::WHITE, PieceType::QUEEN) | state.piecesOf(Color::BLACK, PieceType::QUEEN);
+    Bitboard rooks = state.piecesOf(Color::WHITE, PieceType::ROOK) | state.piecesOf(Color::BLACK, PieceType::ROOK) | queens;
+    Bitboard bishops = state.piecesOf(Color::WHITE, PieceType::BISHOP) | state.piecesOf(Color::BLACK, PieceType::BISHOP) | queens;
+    return (pawnAttacks(Color::BLACK, square) & state.piecesOf(Color::WHITE, PieceType::PAWN)) |
+           (pawnAttacks(Color::WHITE, square) & state.piecesOf(Color::BLACK, PieceType::PAWN)) |
+           (knightAttacks(square) & (state.piecesOf(Color::WHITE, PieceType::KNIGHT) | state.piecesOf(Color::BLACK, PieceType::KNIGHT))) |
+           (kingAttacks(square) & (state.piecesOf(Color::WHITE, PieceType::KING) | state.piecesOf(Color::BLACK, PieceType::KING))) |
+           (rookAttacks(square, occupied) & rooks) |
+           (bishopAttacks(square, occupied) & bishops);
+}
+
+// Squares strictly between two squares on a shared rank, file or diagonal; empty otherwise
+inline Bitboard betweenSquares(int a, int b) {
+    Bitboard aMask = squareMask(a), bMask = squareMask(b);
+    if (rookAttacks(a, 0) & bMask) {
+        return rookAttacks(a, bMask) & rookAttacks(b, aMask);
+    }
+    if (bishopAttacks(a, 0) & bMask) {
+        return bishopAttacks(a, bMask) & bishopAttacks(b, aMask);
+    }
+    return 0;
+}
+
+// The whole rank, file or diagonal through two aligned squares
+inline Bitboard lineThrough(int a, int b) {
+    Bitboard ends = squareMask(a) | squareMask(b);
+    if (rookAttacks(a, 0) & squareMask(b)) {
+        return (rookAttacks(a, 0) & rookAttacks(b, 0)) | ends;
+    }
+    if (bishopAttacks(a, 0) & squareMask(b)) {
+        return (bishopAttacks(a, 0) & bishopAttacks(b, 0)) | ends;
+    }
+    return 0;
+}
+
+// Whether the side to move has any legal move. Instead of trying moves, king
+// moves are checked against the enemy attacks, other pieces are limited to
+// squares that answer a check and pinned pieces to their pin line, and the
+// scan stops at the first move found. Only en passant, whose legality can
+// depend on two pieces leaving a rank, is tried on a scratch board.
+inline bool hasLegalMove(const BoardState& state) {
+    Color us = state.sideToMove;
+    Color them = opposite(us);
+    Bitboard own = state.occupancy[colorIndex(us)];
+    Bitboard enemy = state.occupancy[colorIndex(them)];
+    int king = state.kingSquare(us);
+
+    Bitboard withoutKing = state.occupied ^ squareMask(king);
+    Bitboard kingTargets = kingAttacks(king) & ~own;
+    while (kingTargets) {
+        if (!(attackersTo(state, popLsb(kingTargets), withoutKing) & enemy)) {
+            return true;
+        }
+    }
+
+    Bitboard checkers = attackersTo(state, king, state.occupied) & enemy;
+    if (popCount(checkers) > 1) {
+        return false; // Double check: only the king can move
+    }
+    Bitboard allowed = checkers ? (checkers | betweenSquares(king, lsb(checkers))) : ~own;
+
+    Bitboard enemyQueens = state.piecesOf(them, PieceType::QUEEN);
+    Bitboard snipers = (rookAttacks(king, 0) & (state.piecesOf(them, PieceType::ROOK) | enemyQueens)) |
+                       (bishopAttacks(king, 0) & (state.piecesOf(them, PieceType::BISHOP) | enemyQueens));
+    Bitboard pinned = 0;
+    while (snipers) {
+        Bitboard blockers = betweenSquares(king, popLsb(snipers)) & state.occupied;
+        if (popCount(blockers) == 1 && (blockers & own)) {
+            pinned |= blockers;
+        }
+    }
+
+    Bitboard others = own ^ squareMask(king);
+    while (others) {
+        int from = popLsb(others);
+        Bitboard targets = pieceTargets(state.pieceOn(from), from, own, enemy) & allowed;
+        if (pinned & squareMask(from)) {
+            targets &= lineThrough(king, from);
+        }
+        if (targets) {
+            return true;
+        }
+    }
+
+    if (state.enPassant >= 0) {
+        Bitboard capturers = pawnAttacks(them, state.enPassant) & state.piecesOf(us, PieceType::PAWN);
+        BoardState scratch = state;
+        while (capturers) {
+            Move move(popLsb(capturers), state.enPassant, MOVE_CAPTURE | MOVE_EN_PASSANT);
+            UndoInfo undo;
+            scratch.makeMove(move, undo);
+            bool legal = !isInCheck(scratch, us);
+            scratch.unmakeMove(move, undo);
+            if (legal) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Neither side can ever mate: bare kings, a single minor piece, or only
+// bishops that all stand on squares of one color
+inline bool isInsufficientMaterial(const BoardState& state) {
+    Bitboard kings = state.piecesOf(Color::WHITE, PieceType::KING) | state.piecesOf(Color::BLACK, PieceType::KING);
+    Bitboard bishops = state.piecesOf(Color::WHITE, PieceType::BISHOP) | state.piecesOf(Color::BLACK, PieceType::BISHOP);
+    Bitboard knights = state.piecesOf(Color::WHITE, PieceType::KNIGHT) | state.piecesOf(Color::BLACK, PieceType::KNIGHT);
+    Bitboard rest = state.occupied & ~kings;
+    if (rest & ~(bishops | knights)) {
+        return false; // Pawns, rooks or queens
+    }
+    if (popCount(rest) <= 1) {
+        return true;
+    }
+    const Bitboard DARK_SQUARES = 0xAA55AA55AA55AA55ULL;
+    return knights == 0 && ((bishops & DARK_SQUARES) == 0 || (bishops & ~DARK_SQUARES) == 0);
+}
+
+// Counts leaf nodes of the legal move tree; the standard move generator check.
+// The state is modified during the walk and restored before returning.
+inline uint64_t perft(BoardState& state, int depth) {
+    if (depth == 0) {
+        return 1;
+    }
+    MoveList list;
+    generateLegalMoves(state, list);
+    if (depth == 1) {
+        return list.size();
+    }
+    uint64_t nodes = 0;
+    for (const Move& move : list) {
+        UndoInfo undo;
+        state.makeMove(move, undo);
+        nodes += perft(state, depth - 1);
+        state.unmakeMove(move, undo);
+    }
+    return nodes;
+}
@@ -0,0 +1,112 @@
+/**
+ * Perft: counts the leaf nodes of the legal move tree for the standard test
+ * positions and reports move-generation throughput in nodes/second.
+ *
+ * Usage:
+ *   perft                 run the standard suite
+ *   perft <depth> [fen]   run one position (start position by default)
+ *
+ * The suite also checks that malformed FENs are refused.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "movegen.h"
+
+using namespace std;
+
+struct PerftCase {
+    const char* name;
+    const char* fen;
+    int depth;
+    uint64_t expected;
+};
+
+// Reference counts from the Chess Programming Wiki perft results page
+const PerftCase SUITE[] = {
+    { "start",     "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609 },
+    { "kiwipete",  "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603 },
+    { "position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6, 11030083 },
+    { "position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333 },
+    { "position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487 },
+    { "position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594 },
+};
+
+// Each must make setFromFen return false
+const char* MALFORMED[] = {
+    "4k3/8/8/8/8/8/4P3/4K3 w - z9 0 1",         // En-passant square off the board
+    "4k3/8/8/8/8/8/4P3/4K3 w - e4 0 1",         // En-passant square on the wrong rank
+    "4k3/8/8/3pP3/8/8/8/4K3 b - e6 0 1",        // En-passant rank for the other side
+    "4k3/8/8/8/8/8/4P3/4K3 w - e6 0 1",         // No pawn that just moved past it
+    "4k3/8/8/8/8/8/4P3/4K3 x - - 0 1",          // Side to move
+    "4k3/8/8/8/8/8/4P3/4K3 white - - 0 1",
+    "4k3/8/8/8/8/8/4P3/4K4 w - - 0 1",          // Nine files
+    "4k3/8/8/8/8/8/4P3/4K2 w - - 0 1",          // Seven files
+    "4k3/8/8/8/8/8/4P3/4K3/8 w - - 0 1",        // Nine ranks
+    "4k3/8/8/8/8/8/4K3 w - - 0 1",              // Seven ranks
+    "4k2P/8/8/8/8/8/8/4K3 w - - 0 1",           // Pawn on rank 8
+    "4k3/8/8/8/8/8/8/p3K3 w - - 0 1",           // Pawn on rank 1
+    "4k3/8/8/8/8/8/8/4K3 w K - 0 1",            // Castling right without the rook
+    "3k3r/8/8/8/8/8/8/4K3 w k - 0 1",           // Castling right with the king moved
+    "4k3/8/8/8/8/8/8/R3K2R w X - 0 1",          // Unknown castling letter
+    "4k3/8/8/8/8/8/8/4R1K1 w - - 0 1",          // Side not to move in check
+    "4k3/8/8/8/8/8/8/8 w - - 0 1",              // Missing king
+};
+
+// Runs perft and prints one result line; returns the node count
+uint64_t runPerft(const string& name, BoardState& state, int depth) {
+    auto start = chrono::steady_clock::now();
+    uint64_t nodes = perft(state, depth);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << left << setw(10) << name << " depth " << depth
+         << "  nodes " << setw(10) << nodes
+         << "  " << fixed << setprecision(3) << seconds << "s"
+         << "  " << setprecision(0) << (seconds > 0 ? nodes / seconds : 0.0) << " nodes/s";
+    return nodes;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        int depth = atoi(argv[1]);
+        string fen = (argc > 2) ? argv[2] : SUITE[0].fen;
+        BoardState state;
+        if (!state.setFromFen(fen)) {
+            cerr << "Invalid FEN: " << fen << "\n";
+            return 1;
+        }
+        runPerft("custom", state, depth);
+        cout << "\n";
+        return 0;
+    }
+
+    bool allPassed = true;
+    uint64_t totalNodes = 0;
+    auto start = chrono::steady_clock::now();
+    for (const PerftCase& test : SUITE) {
+        BoardState state;
+        state.setFromFen(test.fen);
+        uint64_t nodes = runPerft(test.name, state, test.depth);
+        bool passed = nodes == test.expected;
+        cout << (passed ? "  ok" : "  FAILED (expected " + to_string(test.expected) + ")") << "\n";
+        allPassed = allPassed && passed;
+        totalNodes += nodes;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    for (const char* fen : MALFORMED) {
+        BoardState state;
+        if (state.setFromFen(fen)) {
+            cout << "accepted malformed FEN: " << fen << "\n";
+            allPassed = false;
+        }
+    }
+    cout << "total " << totalNodes << " nodes in " << fixed << setprecision(3) << seconds << "s, "
+         << setprecision(0) << totalNodes / seconds << " nodes/s\n";
+
+    return allPassed ? 0 : 1;
+}
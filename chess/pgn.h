@@ -0,0 +1,321 @@
+/**
+ * Streaming PGN reader and SAN replay.
+ *
+ * - PgnReader maps a large file (mapped_file.h) one window at a time, so
+ *   memory use stays bounded however big the archive is. Windows are released
+ *   as soon as the last game that points into them has been processed.
+ * - It cuts each window into games (a game starts at a line beginning
+ *   with "[Event ") and hands them out in batches of string_views into the
+ *   mapping, so game text is never copied. A game cut off at the end of a
+ *   window is read again from the start of the next window.
+ * - replayGame parses tags and movetext (comments, variations, NAGs and move
+ *   numbers are skipped), resolves each SAN move against the legal move list
+ *   and plays it through Game::makeMove.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "game.h"
+#include "mapped_file.h"
+
+// Games handed to one worker task. `owner` keeps the backing memory alive.
+struct GameBatch {
+    std::shared_ptr<const void> owner;
+    std::vector<std::string_view> games;
+    uint64_t firstIndex = 0;    // Archive-wide number of games[0]
+};
+
+class PgnReader {
+public:
+    explicit PgnReader(const MappedFile& file, size_t windowBytes = 64 << 20, size_t batchGames = 64)
+        : file(file), windowBytes(windowBytes), batchGames(batchGames) {}
+
+    // Calls onBatch(GameBatch&&) for every batch of complete games in file order.
+    // Returns false if a window could not be mapped.
+    template <typename Callback>
+    bool read(Callback onBatch) {
+        uint64_t index = 0;
+        uint64_t offset = 0;
+        size_t window = windowBytes;
+        while (offset < file.size()) {
+            size_t length = static_cast<size_t>(std::min<uint64_t>(window, file.size() - offset));
+            std::shared_ptr<MappedRegion> region = file.map(offset, length);
+            if (!region) {
+                return false;
+            }
+            std::string_view text(region->data, region->size);
+            bool last = offset + length >= file.size();
+
+            size_t start = findGameStart(text, 0);
+            if (start == std::string_view::npos) {
+                if (last) {
+                    break;
+                }
+                window *= 2; // No game starts in this window yet
+                continue;
+            }
+
+            GameBatch batch;
+            batch.owner = region;
+            batch.firstIndex = index;
+            size_t consumed = text.size();
+            while (start < text.size()) {
+                size_t next = findGameStart(text, start + 1);
+                if (next == std::string_view::npos && !last) {
+                    consumed = start; // Cut off: the next window starts at this game
+                    break;
+                }
+                size_t end = (next == std::string_view::npos) ? text.size() : next;
+                batch.games.push_back(text.substr(start, end - start));
+                index++;
+                if (batch.games.size() == batchGames) {
+                    onBatch(std::move(batch));
+                    batch = GameBatch();
+                    batch.owner = region;
+                    batch.firstIndex = index;
+                }
+                start = end;
+            }
+            if (!batch.games.empty()) {
+                onBatch(std::move(batch));
+            }
+
+            if (consumed == 0) {
+                window *= 2; // A single game longer than the window
+            } else {
+                offset += consumed;
+                window = windowBytes;
+            }
+        }
+        return true;
+    }
+
+private:
+    const MappedFile& file;
+    size_t windowBytes;
+    size_t batchGames;
+
+    static size_t findGameStart(std::string_view text, size_t from) {
+        static const std::string_view tag = "[Event ";
+        if (from == 0 && text.substr(0, tag.size()) == tag) {
+            return 0;
+        }
+        size_t pos = text.find("\n[Event ", from == 0 ? 0 : from - 1);
+        return (pos == std::string_view::npos) ? pos : pos + 1;
+    }
+};
+
+// Finds the legal move written in Standard Algebraic Notation, e.g. "Nbd7", "exd5", "e8=Q+", "O-O"
+inline bool parseSan(const BoardState& state, std::string_view san, Move& out) {
+    // Strip check, mate and annotation suffixes
+    while (!san.empty() && std::strchr("+#!?", san.back())) {
+        san.remove_suffix(1);
+    }
+    if (san.empty()) {
+        return false;
+    }
+
+    MoveList legal;
+    generateLegalMoves(state, legal);
+
+    if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0") {
+        bool kingside = san.size() == 3;
+        for (const Move& m : legal) {
+            if ((m.flags() & MOVE_CASTLING) && ((m.to() > m.from()) == kingside)) {
+                out = m;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    PieceType piece = PieceType::PAWN;
+    static const std::string_view letters = "PRNBQK";
+    size_t i = 0;
+    if (letters.find(san[0]) != std::string_view::npos && san[0] != 'P') {
+        piece = static_cast<PieceType>(letters.find(san[0]));
+        i = 1;
+    }
+
+    bool promotes = false;
+    PieceType promotion = PieceType::QUEEN;
+    size_t eq = san.find('=');
+    if (eq != std::string_view::npos && eq + 1 < san.size()) {
+        promotes = true;
+        size_t p = letters.find(san[eq + 1]);
+        if (p == std::string_view::npos || p == 0 || p == 5) {
+            return false;
+        }
+        promotion = static_cast<PieceType>(p);
+        san = san.substr(0, eq);
+    } else if (piece == PieceType::PAWN && san.size() >= 3 &&
+               letters.find(san.back()) != std::string_view::npos && san.back() != 'P' && san.back() != 'K') {
+        promotes = true; // "e8Q" without '='
+        promotion = static_cast<PieceType>(letters.find(san.back()));
+        san.remove_suffix(1);
+    }
+
+    if (san.size() < i + 2) {
+        return false;
+    }
+    int toFile = san[san.size() - 2] - 'a';
+    int toRank = san[san.size() - 1] - '1';
+    if (toFile < 0 || toFile > 7 || toRank < 0 || toRank > 7) {
+        return false;
+    }
+    int to = squareIndex(toRank, toFile);
+
+    // Whatever lies between the piece letter and the target is disambiguation
+    int fromFile = -1, fromRank = -1;
+    for (size_t j = i; j + 2 < san.size(); j++) {
+        char c = san[j];
+        if (c >= 'a' && c <= 'h') fromFile = c - 'a';
+        else if (c >= '1' && c <= '8') fromRank = c - '1';
+    }
+
+    int matches = 0;
+    for (const Move& m : legal) {
+        PieceType moving = pieceType(state.pieceOn(m.from()));
+        if (m.to() != to || moving != piece || (m.flags() & MOVE_CASTLING) ||
+            m.isPromotion() != promotes || (promotes && m.promotion() != promotion) ||
+            (fromFile >= 0 && m.from() % 8 != fromFile) || (fromRank >= 0 && m.from() / 8 != fromRank)) {
+            continue;
+        }
+        out = m;
+        matches++;
+    }
+    return matches == 1;
+}
+
+struct GameStats {
+    uint64_t index = 0;
+    std::string white, black, result;
+    int plies = 0;
+    int captures = 0;
+    int checks = 0;
+    int castles = 0;
+    int promotions = 0;
+    uint64_t finalHash = 0;
+    std::string error;        // Empty if the whole game replayed
+};
+
+// Value of a tag such as [White "Carlsen, Magnus"]
+inline std::string_view tagValue(std::string_view line) {
+    size_t open = line.find('"');
+    size_t close = line.rfind('"');
+    if (open == std::string_view::npos || close <= open) {
+        return {};
+    }
+    return line.substr(open + 1, close - open - 1);
+}
+
+// Called with the position before each mainline move, e.g. to collect book moves
+using MoveVisitor = std::function<void(const BoardState&, const Move&)>;
+
+inline GameStats replayGame(std::string_view text, uint64_t index, const MoveVisitor& onMove = nullptr) {
+    GameStats stats;
+    stats.index = index;
+
+    // Tag section
+    std::string fen;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t lineEnd = text.find('\n', pos);
+        if (lineEnd == std::string_view::npos) lineEnd = text.size();
+        std::string_view line = text.substr(pos, lineEnd - pos);
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos) {
+            pos = lineEnd + 1;
+            continue;
+        }
+        if (line[first] != '[') {
+            break;
+        }
+        line = line.substr(first);
+        if (line.compare(0, 7, "[White ") == 0) stats.white = std::string(tagValue(line));
+        else if (line.compare(0, 7, "[Black ") == 0) stats.black = std::string(tagValue(line));
+        else if (line.compare(0, 8, "[Result ") == 0) stats.result = std::string(tagValue(line));
+        else if (line.compare(0, 5, "[FEN ") == 0) fen = std::string(tagValue(line));
+        pos = lineEnd + 1;
+    }
+    BoardState start;
+    if (!fen.empty() && !start.setFromFen(fen)) {
+        stats.error = "invalid FEN tag";
+        return stats;
+    }
+
+    Player white(stats.white, Color::WHITE), black(stats.black, Color::BLACK);
+    Game game = fen.empty() ? Game(white, black) : Game(white, black, fen);
+    int variationDepth = 0;
+    while (pos < text.size()) {
+        char c = text[pos];
+        if (c == '{') {                       // Comment
+            size_t end = text.find('}', pos);
+            pos = (end == std::string_view::npos) ? text.size() : end + 1;
+            continue;
+        }
+        if (c == ';') {                       // Rest-of-line comment
+            size_t end = text.find('\n', pos);
+            pos = (end == std::string_view::npos) ? text.size() : end + 1;
+            continue;
+        }
+        if (c == '(') { variationDepth++; pos++; continue; }
+        if (c == ')') { variationDepth--; pos++; continue; }
+        if (std::isspace(static_cast<unsigned char>(c))) { pos++; continue; }
+
+        size_t end = pos;
+        while (end < text.size() && !std::isspace(static_cast<unsigned char>(text[end])) &&
+               !std::strchr("{}();", text[end])) {
+            end++;
+        }
+        std::string_view token = text.substr(pos, end - pos);
+        pos = end;
+
+        if (variationDepth > 0 || token[0] == '$') {
+            continue;                         // Side line or NAG
+        }
+        if (token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*") {
+            break;
+        }
+        // Move number ("12." or "12...") possibly glued to the move ("12.e4")
+        size_t digits = 0;
+        while (digits < token.size() && std::isdigit(static_cast<unsigned char>(token[digits]))) digits++;
+        if (digits > 0 && digits < token.size() && token[digits] == '.') {
+            while (digits < token.size() && token[digits] == '.') digits++;
+            token = token.substr(digits);
+        } else if (digits == token.size()) {
+            continue;
+        }
+        if (token.empty()) {
+            continue;
+        }
+
+        const BoardState& state = game.getBoard().getState();
+        Move move;
+        bool parsed = parseSan(state, token, move);
+        if (parsed && onMove) {
+            onMove(state, move);
+        }
+        if (!parsed || !game.makeMove(move)) {
+            stats.error = "illegal or ambiguous move " + std::string(token) + " at ply " + std::to_string(stats.plies + 1);
+            break;
+        }
+        game.switchTurn();
+        stats.plies++;
+        stats.captures += move.isCapture();
+        stats.promotions += move.isPromotion();
+        stats.castles += (move.flags() & MOVE_CASTLING) != 0;
+        stats.checks += isInCheck(game.getBoard().getState(), game.getBoard().getState().sideToMove);
+    }
+    stats.finalHash = game.getBoard().getHash();
+    return stats;
+}
@@ -0,0 +1,143 @@
+/**
+ * Move-validation microbenchmark: virtual Piece objects against PieceCode bytes.
+ *
+ * The same random (from, to) queries are answered three ways:
+ *   virtual  - a grid of shared_ptr<Piece> from PieceFactory, one virtual call per check
+ *   switch   - the mailbox byte and pieceTargets(), same empty-board rules
+ *   board    - isPseudoLegalTarget(), the full rules with blocking and captures
+ * Heap allocations needed to set each board up are counted as well.
+ *
+ * Usage: piece_bench [queries]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include "game.h"
+
+using namespace std;
+
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    if (void* p = malloc(size)) {
+        return p;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+const char* POSITIONS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+};
+
+struct Query {
+    uint8_t position;
+    uint8_t from;
+    uint8_t to;
+};
+
+template <typename F>
+static double timeLoop(const vector<Query>& queries, uint64_t& valid, F check) {
+    valid = 0;
+    auto start = chrono::steady_clock::now();
+    for (const Query& q : queries) {
+        valid += check(q);
+    }
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 20000000;
+    const int positionCount = sizeof(POSITIONS) / sizeof(POSITIONS[0]);
+
+    BoardState parsed[positionCount];
+    for (int i = 0; i < positionCount; i++) {
+        parsed[i].setFromFen(POSITIONS[i]);
+    }
+
+    // Value-type boards: pieces are bytes in the mailbox
+    size_t before = allocations;
+    BoardState states[positionCount];
+    for (int i = 0; i < positionCount; i++) {
+        for (int sq = 0; sq < 64; sq++) {
+            Color color;
+            PieceType type;
+            if (parsed[i].pieceAt(sq, color, type)) {
+                states[i].addPiece(color, type, sq);
+            }
+        }
+    }
+    size_t valueAllocations = allocations - before;
+
+    // Object boards, as the original ChessBoard held them
+    before = allocations;
+    vector<vector<shared_ptr<Piece>>> grids(positionCount, vector<shared_ptr<Piece>>(64));
+    for (int i = 0; i < positionCount; i++) {
+        for (int sq = 0; sq < 64; sq++) {
+            Color color;
+            PieceType type;
+            if (parsed[i].pieceAt(sq, color, type)) {
+                grids[i][sq] = PieceFactory::createPiece(type, color, Position(sq / 8, sq % 8));
+            }
+        }
+    }
+    size_t objectAllocations = allocations - before;
+
+    // Random queries from occupied squares, fixed seed so runs are comparable
+    vector<Query> queries(count);
+    uint64_t seed = 0x2545F4914F6CDD1DULL;
+    for (Query& q : queries) {
+        do {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            q.position = static_cast<uint8_t>(seed % positionCount);
+            q.from = static_cast<uint8_t>((seed >> 8) & 63);
+            q.to = static_cast<uint8_t>((seed >> 16) & 63);
+        } while (states[q.position].isEmpty(q.from));
+    }
+
+    uint64_t virtualValid, switchValid, boardValid;
+    double virtualTime = timeLoop(queries, virtualValid, [&](const Query& q) {
+        Position from(q.from / 8, q.from % 8), to(q.to / 8, q.to % 8);
+        return grids[q.position][q.from]->isValidMove(from, to);
+    });
+    double switchTime = timeLoop(queries, switchValid, [&](const Query& q) {
+        PieceCode piece = states[q.position].pieceOn(q.from);
+        return (pieceTargets(piece, q.from, 0, 0) & squareMask(q.to)) != 0;
+    });
+    double boardTime = timeLoop(queries, boardValid, [&](const Query& q) {
+        return isPseudoLegalTarget(parsed[q.position], q.from, q.to);
+    });
+
+    if (virtualValid != switchValid) {
+        cout << "MISMATCH: virtual " << virtualValid << " vs switch " << switchValid << "\n";
+        return 1;
+    }
+
+    cout << count << " queries over " << positionCount << " positions\n";
+    cout << fixed << setprecision(2);
+    cout << "  virtual  " << setw(7) << virtualTime * 1e9 / count << " ns/check  "
+         << objectAllocations << " allocations to set up\n";
+    cout << "  switch   " << setw(7) << switchTime * 1e9 / count << " ns/check  "
+         << valueAllocations << " allocations to set up  (" << virtualTime / switchTime << "x)\n";
+    cout << "  board    " << setw(7) << boardTime * 1e9 / count << " ns/check  "
+         << "with blocking, " << boardValid << " valid\n";
+    return 0;
+}
@@ -0,0 +1,128 @@
+/**
+ * Material and piece-square tables for the static evaluation.
+ *
+ * Every (color, piece, square) has a midgame and an endgame score with the
+ * piece's material value folded in, white positive and black negative. A
+ * position's score is the sum over its pieces, so BoardState keeps the two
+ * sums current as pieces are added, removed and moved, just as it does the
+ * Zobrist key, and evaluation blends them by the remaining material.
+ *
+ * The tables are stored structure-of-arrays (all midgame scores, then all
+ * endgame scores, one contiguous 64-entry row per piece) so the rare full
+ * recompute is a masked add over whole rows that the compiler vectorizes.
+ * Values are the well-known "simplified evaluation function" set; only the
+ * king has a separate endgame table.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// Game phase: 24 with all minor and major pieces on the board, 0 with none
+const int PHASE_MAX = 24;
+
+struct PieceSquareTables {
+    int16_t mg[2][6][64];
+    int16_t eg[2][6][64];
+    int16_t material[6];  // Pawn, Rook, Knight, Bishop, Queen, King
+    int8_t phase[6];      // Contribution of each piece to the game phase
+    int16_t laneMask[256][8]; // One rank of a bitboard expanded to 0 / -1 per file
+
+    constexpr PieceSquareTables()
+        : mg{}, eg{}, material{ 100, 500, 320, 330, 900, 0 }, phase{ 0, 2, 1, 1, 4, 0 }, laneMask{} {
+        for (int bits = 0; bits < 256; bits++) {
+            for (int file = 0; file < 8; file++) {
+                laneMask[bits][file] = static_cast<int16_t>(((bits >> file) & 1) ? -1 : 0);
+            }
+        }
+        for (int t = 0; t < 6; t++) {
+            for (int sq = 0; sq < 64; sq++) {
+                // Tables below are written rank 8 first, so white reads them
+                // flipped and black, mirrored, reads them as printed
+                bool kingEndgame = (t == 5);
+                mg[0][t][sq] = static_cast<int16_t>(material[t] + MIDGAME[t][sq ^ 56]);
+                eg[0][t][sq] = static_cast<int16_t>(material[t] + (kingEndgame ? KING_ENDGAME[sq ^ 56] : MIDGAME[t][sq ^ 56]));
+                mg[1][t][sq] = static_cast<int16_t>(-(material[t] + MIDGAME[t][sq]));
+                eg[1][t][sq] = static_cast<int16_t>(-(material[t] + (kingEndgame ? KING_ENDGAME[sq] : MIDGAME[t][sq])));
+            }
+        }
+    }
+
+private:
+    static constexpr int8_t MIDGAME[6][64] = {
+        { // Pawn
+             0,  0,  0,  0,  0,  0,  0,  0,
+            50, 50, 50, 50, 50, 50, 50, 50,
+            10, 10, 20, 30, 30, 20, 10, 10,
+             5,  5, 10, 25, 25, 10,  5,  5,
+             0,  0,  0, 20, 20,  0,  0,  0,
+             5, -5,-10,  0,  0,-10, -5,  5,
+             5, 10, 10,-20,-20, 10, 10,  5,
+             0,  0,  0,  0,  0,  0,  0,  0
+        },
+        { // Rook
+             0,  0,  0,  0,  0,  0,  0,  0,
+             5, 10, 10, 10, 10, 10, 10,  5,
+            -5,  0,  0,  0,  0,  0,  0, -5,
+            -5,  0,  0,  0,  0,  0,  0, -5,
+            -5,  0,  0,  0,  0,  0,  0, -5,
+            -5,  0,  0,  0,  0,  0,  0, -5,
+            -5,  0,  0,  0,  0,  0,  0, -5,
+             0,  0,  0,  5,  5,  0,  0,  0
+        },
+        { // Knight
+           -50,-40,-30,-30,-30,-30,-40,-50,
+           -40,-20,  0,  0,  0,  0,-20,-40,
+           -30,  0, 10, 15, 15, 10,  0,-30,
+           -30,  5, 15, 20, 20, 15,  5,-30,
+           -30,  0, 15, 20, 20, 15,  0,-30,
+           -30,  5, 10, 15, 15, 10,  5,-30,
+           -40,-20,  0,  5,  5,  0,-20,-40,
+           -50,-40,-30,-30,-30,-30,-40,-50
+        },
+        { // Bishop
+           -20,-10,-10,-10,-10,-10,-10,-20,
+           -10,  0,  0,  0,  0,  0,  0,-10,
+           -10,  0,  5, 10, 10,  5,  0,-10,
+           -10,  5,  5, 10, 10,  5,  5,-10,
+           -10,  0, 10, 10, 10, 10,  0,-10,
+           -10, 10, 10, 10, 10, 10, 10,-10,
+           -10,  5,  0,  0,  0,  0,  5,-10,
+           -20,-10,-10,-10,-10,-10,-10,-20
+        },
+        { // Queen
+           -20,-10,-10, -5, -5,-10,-10,-20,
+           -10,  0,  0,  0,  0,  0,  0,-10,
+           -10,  0,  5,  5,  5,  5,  0,-10,
+            -5,  0,  5,  5,  5,  5,  0, -5,
+             0,  0,  5,  5,  5,  5,  0, -5,
+           -10,  5,  5,  5,  5,  5,  0,-10,
+           -10,  0,  5,  0,  0,  0,  0,-10,
+           -20,-10,-10, -5, -5,-10,-10,-20
+        },
+        { // King, midgame: stay behind the pawns
+           -30,-40,-40,-50,-50,-40,-40,-30,
+           -30,-40,-40,-50,-50,-40,-40,-30,
+           -30,-40,-40,-50,-50,-40,-40,-30,
+           -30,-40,-40,-50,-50,-40,-40,-30,
+           -20,-30,-30,-40,-40,-30,-30,-20,
+           -10,-20,-20,-20,-20,-20,-20,-10,
+            20, 20,  0,  0,  0,  0, 20, 20,
+            20, 30, 10,  0,  0, 10, 30, 20
+        }
+    };
+
+    // King, endgame: head for the centre
+    static constexpr int8_t KING_ENDGAME[64] = {
+       -50,-40,-30,-20,-20,-30,-40,-50,
+       -30,-20,-10,  0,  0,-10,-20,-30,
+       -30,-10, 20, 30, 30, 20,-10,-30,
+       -30,-10, 30, 40, 40, 30,-10,-30,
+       -30,-10, 30, 40, 40, 30,-10,-30,
+       -30,-10, 20, 30, 30, 20,-10,-30,
+       -30,-30,  0,  0,  0,  0,-30,-30,
+       -50,-30,-30,-30,-30,-30,-30,-50
+    };
+};
+
+inline constexpr PieceSquareTables PST{};
@@ -0,0 +1,488 @@
+/**
+ * Alpha-beta search engine.
+ *
+ * - Negamax alpha-beta with iterative deepening: depth 1, 2, 3, ... until the
+ *   time budget runs out; the best move of the last finished iteration wins.
+ * - Quiescence search at the leaves resolves pending captures so the static
+ *   evaluation is not taken in the middle of an exchange.
+ * - Move ordering: MVV-LVA for captures, two killer moves per ply for quiet
+ *   moves that caused a cutoff, then the history heuristic.
+ *
+ * - A transposition table (tt.h) returns cutoffs and best moves for positions
+ *   reached by other move orders; engines can share one table.
+ * - Lazy SMP: with several threads, helpers run the same search and
+ *   communicate only through the shared table.
+ * - An optional opening book (book.h) and endgame tablebase (tablebase.h)
+ *   answer known positions without searching; the tablebase is also probed
+ *   inside the tree once three pieces are left.
+ *
+ * The search runs on a private BoardState with make/unmake, so it performs
+ * no allocation per node.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "book.h"
+#include "movegen.h"
+#include "tablebase.h"
+#include "tt.h"
+
+const int MAX_PLY = 128;
+const int INFINITE_SCORE = 32000;
+const int MATE_SCORE = 31000;  // Mate in N plies scores MATE_SCORE - N
+
+struct SearchLimits {
+    int maxDepth = 64;
+    int timeMs = 1000;   // Wall-clock budget per move
+    int threads = 1;     // Search threads sharing one transposition table
+    bool verbose = false; // Print one line per finished iteration
+};
+
+enum class MoveSource {
+    SEARCH, BOOK, TABLEBASE
+};
+
+struct SearchResult {
+    Move bestMove;
+    MoveSource source = MoveSource::SEARCH;
+    bool hasMove = false;
+    int score = 0;
+    int depth = 0;       // Last fully searched depth
+    uint64_t nodes = 0;
+    double seconds = 0;
+    TTStats tt;
+    int hashfull = 0;    // Permille of the table filled by this search
+
+    double nodesPerSecond() const {
+        return seconds > 0 ? nodes / seconds : 0;
+    }
+};
+
+inline int pieceValue(PieceType t) {
+    return PST.material[typeIndex(t)];
+}
+
+class SearchEngine {
+private:
+    std::shared_ptr<TranspositionTable> tt;
+    TTStats ttStats;
+    BoardState state;
+    uint64_t nodes = 0;
+    bool stopped = false;
+    const std::atomic<bool>* stopSignal = nullptr; // Raised by the main thread to end helper searches
+    std::chrono::steady_clock::time_point deadline;
+    std::vector<std::unique_ptr<SearchEngine>> helpers; // Lazy SMP threads, created on demand
+    std::shared_ptr<const OpeningBook> book;
+    std::shared_ptr<const Tablebase> tablebase;
+    uint64_t bookRandom = 0x9E3779B97F4A7C15ULL;        // Xorshift state for weighted book picks
+
+    Move killers[MAX_PLY][2];
+    int history[2][64][64];
+    // Keys of the positions played before the root since the last capture
+    // or pawn move, then of those on the current line: ply p is at
+    // rootIndex + p. Sized once per search, for repetitions.
+    std::vector<uint64_t> pathHashes;
+    int rootIndex = 0;
+
+public:
+    // Engines given the same table share results; by default each gets its own
+    explicit SearchEngine(std::shared_ptr<TranspositionTable> table = nullptr)
+        : tt(table ? table : std::make_shared<TranspositionTable>()) {}
+
+    void setBook(std::shared_ptr<const OpeningBook> openingBook) {
+        book = openingBook;
+    }
+
+    void setTablebase(std::shared_ptr<const Tablebase> tb) {
+        tablebase = tb;
+    }
+
+    // Searches with limits.threads threads (Lazy SMP): helper engines search
+    // the same root at staggered depths and share the transposition table, so
+    // each finds cutoffs the others stored. The main thread's result is used.
+    // `played` holds the keys of the game's positions before the root, oldest
+    // first (ChessBoard::playedHashes), so lines repeating them score as draws.
+    SearchResult search(const BoardState& root, const SearchLimits& limits,
+                        const std::vector<uint64_t>& played = std::vector<uint64_t>()) {
+        auto start = std::chrono::steady_clock::now();
+        SearchResult result;
+        if (probeRoot(root, result)) {
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return result;
+        }
+        std::atomic<bool> stopSignal(false);
+        tt->newSearch();
+
+        while (static_cast<int>(helpers.size()) < limits.threads - 1) {
+            helpers.emplace_back(new SearchEngine(tt));
+        }
+        for (auto& helper : helpers) {
+            helper->tablebase = tablebase;
+        }
+        std::vector<std::thread> threads;
+        for (int i = 0; i < limits.threads - 1; i++) {
+            threads.emplace_back([this, &root, &limits, &played, start, &stopSignal, i] {
+                SearchResult ignored;
+                helpers[i]->iterate(root, played, limits, start, i + 1, &stopSignal, ignored);
+            });
+        }
+
+        iterate(root, played, limits, start, 0, &stopSignal, result);
+        stopSignal.store(true, std::memory_order_relaxed);
+        for (std::thread& t : threads) {
+            t.join();
+        }
+
+        for (int i = 0; i < limits.threads - 1; i++) {
+            result.nodes += helpers[i]->nodes;
+            result.tt.add(helpers[i]->ttStats);
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.hashfull = tt->hashfull();
+        return result;
+    }
+
+    // Material and piece-square score from the side to move's point of view
+    int evaluate() const {
+        int score = state.evaluation();
+        return (state.sideToMove == Color::WHITE) ? score : -score;
+    }
+
+private:
+    // Mate scores for a tablebase result, relative to the root like search scores
+    static int tbScore(const TBResult& tb, int ply) {
+        if (tb.wdl > 0) return MATE_SCORE - ply - tb.plies;
+        if (tb.wdl < 0) return -MATE_SCORE + ply + tb.plies;
+        return 0;
+    }
+
+    // Answers from the book, or from the tablebase by probing each root move
+    bool probeRoot(const BoardState& root, SearchResult& result) {
+        if (book) {
+            bookRandom ^= bookRandom << 13;
+            bookRandom ^= bookRandom >> 7;
+            bookRandom ^= bookRandom << 17;
+            if (book->probe(root, bookRandom, result.bestMove)) {
+                result.hasMove = true;
+                result.source = MoveSource::BOOK;
+                return true;
+            }
+        }
+        TBResult tb;
+        if (!tablebase || !tablebase->probe(root, tb)) {
+            return false;
+        }
+        MoveList moves;
+        generateLegalMoves(root, moves);
+        if (moves.size() == 0) {
+            return false;
+        }
+        BoardState scratch = root;
+        result.score = -INFINITE_SCORE;
+        for (const Move& move : moves) {
+            UndoInfo undo;
+            TBResult child;
+            scratch.makeMove(move, undo);
+            // Only an underpromotion to a minor piece leaves the tables, and that is a draw
+            int score = tablebase->probe(scratch, child) ? -tbScore(child, 1) : 0;
+            scratch.unmakeMove(move, undo);
+            if (score > result.score) {
+                result.score = score;
+                result.bestMove = move;
+            }
+        }
+        result.hasMove = true;
+        result.source = MoveSource::TABLEBASE;
+        return true;
+    }
+
+    // Iterative deepening on this engine's own board. Helper threads (id > 0)
+    // start odd ids one ply deeper so threads spread over different depths.
+    void iterate(const BoardState& root, const std::vector<uint64_t>& played, const SearchLimits& limits,
+                 std::chrono::steady_clock::time_point start, int id,
+                 const std::atomic<bool>* stop, SearchResult& result) {
+        deadline = start + std::chrono::milliseconds(limits.timeMs);
+        stopSignal = stop;
+        state = root;
+        // Only positions since the last capture or pawn move can repeat
+        rootIndex = std::min(static_cast<int>(played.size()), root.halfmoveClock);
+        pathHashes.assign(played.end() - rootIndex, played.end());
+        pathHashes.resize(rootIndex + MAX_PLY);
+        nodes = 0;
+        stopped = false;
+        ttStats = TTStats();
+        std::memset(killers, 0, sizeof(killers));
+        std::memset(history, 0, sizeof(history));
+
+        MoveList rootMoves;
+        generateLegalMoves(state, rootMoves);
+        if (rootMoves.size() == 0) {
+            return;
+        }
+        result.bestMove = rootMoves[0];
+        result.hasMove = true;
+
+        for (int depth = 1 + (id & 1); depth <= limits.maxDepth && depth < MAX_PLY; depth++) {
+            Move best;
+            int score = searchRoot(rootMoves, depth, best);
+            if (stopped) {
+                break;
+            }
+            result.bestMove = best;
+            result.score = score;
+            result.depth = depth;
+            if (limits.verbose && id == 0) {
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                std::cout << "info depth " << depth << " score " << score << " nodes " << nodes
+                          << " nps " << static_cast<uint64_t>(seconds > 0 ? nodes / seconds : 0)
+                          << " tthits " << static_cast<int>(ttStats.hitRate() * 100) << "%"
+                          << " hashfull " << tt->hashfull() << "\n";
+            }
+            // A forced mate will not get any better with more depth
+            if (score >= MATE_SCORE - MAX_PLY || score <= -MATE_SCORE + MAX_PLY) {
+                break;
+            }
+        }
+        result.nodes = nodes;
+        result.tt = ttStats;
+    }
+
+    int searchRoot(MoveList& moves, int depth, Move& best) {
+        int alpha = -INFINITE_SCORE, beta = INFINITE_SCORE;
+        int scores[MAX_MOVES];
+        scoreMoves(moves, scores, 0, best);
+        for (int i = 0; i < moves.size(); i++) {
+            pickMove(moves, scores, i);
+            const Move& move = moves[i];
+            UndoInfo undo;
+            pathHashes[rootIndex] = state.hash;
+            state.makeMove(move, undo);
+            int score = -negamax(depth - 1, -beta, -alpha, 1);
+            state.unmakeMove(move, undo);
+            if (stopped) {
+                break;
+            }
+            if (score > alpha) {
+                alpha = score;
+                best = move;
+            }
+        }
+        // Search the best move first on the next iteration
+        for (int i = 0; i < moves.size(); i++) {
+            if (moves[i] == best) {
+                std::swap(moves[0], moves[i]);
+                break;
+            }
+        }
+        return alpha;
+    }
+
+    int negamax(int depth, int alpha, int beta, int ply) {
+        if (checkTime()) {
+            return 0;
+        }
+        if (isDraw(ply)) {
+            return 0;
+        }
+        TBResult tb;
+        if (tablebase && popCount(state.occupied) <= 3 && tablebase->probe(state, tb)) {
+            return tbScore(tb, ply);
+        }
+        bool inCheck = isInCheck(state, state.sideToMove);
+        if (inCheck) {
+            depth++; // Check extension: never drop into quiescence while in check
+        }
+        if (depth <= 0) {
+            return quiescence(alpha, beta, ply);
+        }
+        if (ply >= MAX_PLY - 1) {
+            return evaluate();
+        }
+        nodes++;
+
+        TTEntryData entry;
+        Move ttMove;
+        if (tt->probe(state.hash, entry, ttStats)) {
+            ttMove = entry.move;
+            if (entry.depth >= depth) {
+                int score = scoreFromTT(entry.score, ply, MATE_SCORE - MAX_PLY);
+                if (entry.bound == BOUND_EXACT ||
+                    (entry.bound == BOUND_LOWER && score >= beta) ||
+                    (entry.bound == BOUND_UPPER && score <= alpha)) {
+                    return score;
+                }
+            }
+        }
+
+        MoveList moves;
+        int scores[MAX_MOVES];
+        generatePseudoLegalMoves(state, moves);
+        scoreMoves(moves, scores, ply, ttMove);
+
+        Color us = state.sideToMove;
+        int originalAlpha = alpha;
+        Move bestMove;
+        int legalMoves = 0;
+        pathHashes[rootIndex + ply] = state.hash;
+        for (int i = 0; i < moves.size(); i++) {
+            pickMove(moves, scores, i);
+            const Move& move = moves[i];
+            UndoInfo undo;
+            state.makeMove(move, undo);
+            if (isInCheck(state, us)) {
+                state.unmakeMove(move, undo);
+                continue;
+            }
+            legalMoves++;
+            int score = -negamax(depth - 1, -beta, -alpha, ply + 1);
+            state.unmakeMove(move, undo);
+            if (stopped) {
+                return 0;
+            }
+            if (score >= beta) {
+                if (!move.isCapture()) {
+                    storeKiller(move, ply);
+                    int& h = history[colorIndex(us)][move.from()][move.to()];
+                    h = std::min(h + depth * depth, 700000); // Stay below the killer scores
+                }
+                tt->store(state.hash, move, scoreToTT(beta, ply, MATE_SCORE - MAX_PLY), depth, BOUND_LOWER, ttStats);
+                return beta;
+            }
+            if (score > alpha) {
+                alpha = score;
+                bestMove = move;
+            }
+        }
+
+        if (legalMoves == 0) {
+            return inCheck ? -MATE_SCORE + ply : 0; // Checkmate or stalemate
+        }
+        tt->store(state.hash, bestMove, scoreToTT(alpha, ply, MATE_SCORE - MAX_PLY), depth,
+                  (alpha > originalAlpha) ? BOUND_EXACT : BOUND_UPPER, ttStats);
+        return alpha;
+    }
+
+    int quiescence(int alpha, int beta, int ply) {
+        if (checkTime()) {
+            return 0;
+        }
+        nodes++;
+        int standPat = evaluate();
+        if (standPat >= beta || ply >= MAX_PLY - 1) {
+            return standPat;
+        }
+        if (standPat > alpha) {
+            alpha = standPat;
+        }
+
+        MoveList all, moves;
+        generatePseudoLegalMoves(state, all);
+        for (const Move& move : all) {
+            if (move.isCapture() || move.isPromotion()) {
+                moves.add(move);
+            }
+        }
+        int scores[MAX_MOVES];
+        scoreMoves(moves, scores, ply, Move());
+
+        Color us = state.sideToMove;
+        for (int i = 0; i < moves.size(); i++) {
+            pickMove(moves, scores, i);
+            const Move& move = moves[i];
+            UndoInfo undo;
+            state.makeMove(move, undo);
+            if (isInCheck(state, us)) {
+                state.unmakeMove(move, undo);
+                continue;
+            }
+            int score = -quiescence(-beta, -alpha, ply + 1);
+            state.unmakeMove(move, undo);
+            if (stopped) {
+                return 0;
+            }
+            if (score >= beta) {
+                return beta;
+            }
+            if (score > alpha) {
+                alpha = score;
+            }
+        }
+        return alpha;
+    }
+
+    // Polls the clock and the shared stop signal every few thousand nodes
+    bool checkTime() {
+        if ((nodes & 2047) == 0 &&
+            (stopSignal->load(std::memory_order_relaxed) || std::chrono::steady_clock::now() >= deadline)) {
+            stopped = true;
+        }
+        return stopped;
+    }
+
+    // Fifty-move rule, or a repetition of a position earlier on the search
+    // path or in the game before the root
+    bool isDraw(int ply) const {
+        if (state.halfmoveClock >= 100) {
+            return true;
+        }
+        for (int i = ply - 2; i >= -rootIndex && i >= ply - state.halfmoveClock; i -= 2) {
+            if (pathHashes[rootIndex + i] == state.hash) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void storeKiller(const Move& move, int ply) {
+        if (!(killers[ply][0] == move)) {
+            killers[ply][1] = killers[ply][0];
+            killers[ply][0] = move;
+        }
+    }
+
+    // Higher scores are searched first
+    void scoreMoves(const MoveList& moves, int* scores, int ply, const Move& first) {
+        Color us = state.sideToMove;
+        for (int i = 0; i < moves.size(); i++) {
+            const Move& move = moves[i];
+            PieceType attacker = pieceType(state.pieceOn(move.from()));
+            if (move == first && !first.isNull()) {
+                scores[i] = 2000000;
+            } else if (move.isCapture()) {
+                // MVV-LVA: most valuable victim first, least valuable attacker breaks ties
+                PieceCode target = state.pieceOn(move.to());
+                PieceType victim = (target == NO_PIECE) ? PieceType::PAWN : pieceType(target); // En passant
+                scores[i] = 1000000 + pieceValue(victim) * 10 - pieceValue(attacker) / 10;
+            } else if (move.isPromotion()) {
+                scores[i] = 950000 + pieceValue(move.promotion());
+            } else if (killers[ply][0] == move) {
+                scores[i] = 900000;
+            } else if (killers[ply][1] == move) {
+                scores[i] = 800000;
+            } else {
+                scores[i] = history[colorIndex(us)][move.from()][move.to()];
+            }
+        }
+    }
+
+    // Selection sort step: moves the best remaining move to index i
+    static void pickMove(MoveList& moves, int* scores, int i) {
+        int best = i;
+        for (int j = i + 1; j < moves.size(); j++) {
+            if (scores[j] > scores[best]) {
+                best = j;
+            }
+        }
+        std::swap(moves[i], moves[best]);
+        std::swap(scores[i], scores[best]);
+    }
+};
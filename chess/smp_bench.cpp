@@ -0,0 +1,68 @@
+/**
+ * Lazy-SMP scaling benchmark: time-to-depth for 1, 2, 4, ... N threads.
+ *
+ * Each thread count searches the same positions to a fixed depth with a
+ * fresh transposition table, and the total time is compared with the
+ * single-threaded run.
+ *
+ * Usage: smp_bench [depth] [max threads] [hash MB]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "search.h"
+
+using namespace std;
+
+const char* POSITIONS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+};
+
+int main(int argc, char* argv[]) {
+    int depth = (argc > 1) ? atoi(argv[1]) : 8;
+    int maxThreads = (argc > 2) ? atoi(argv[2]) : static_cast<int>(thread::hardware_concurrency());
+    size_t hashMb = (argc > 3) ? strtoul(argv[3], nullptr, 10) : 64;
+    if (maxThreads < 1) {
+        maxThreads = 1;
+    }
+
+    cout << "depth " << depth << ", up to " << maxThreads << " threads, " << hashMb << " MB hash\n";
+    double baseline = 0;
+    for (int threads = 1; threads <= maxThreads; ) {
+        SearchLimits limits;
+        limits.maxDepth = depth;
+        limits.timeMs = 24 * 60 * 60 * 1000; // Depth-limited only
+        limits.threads = threads;
+
+        uint64_t nodes = 0;
+        auto start = chrono::steady_clock::now();
+        for (const char* fen : POSITIONS) {
+            BoardState state;
+            state.setFromFen(fen);
+            SearchEngine engine(make_shared<TranspositionTable>(hashMb));
+            nodes += engine.search(state, limits).nodes;
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (threads == 1) {
+            baseline = seconds;
+        }
+
+        cout << setw(3) << threads << " threads  " << fixed << setprecision(3) << seconds << "s"
+             << "  speedup " << setprecision(2) << baseline / seconds
+             << "  " << setprecision(0) << nodes / seconds << " nodes/s\n";
+
+        // Double each round, always ending on the requested maximum
+        if (threads == maxThreads) {
+            break;
+        }
+        threads = (threads * 2 > maxThreads) ? maxThreads : threads * 2;
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+/**
+ * Game-end detection overhead: random games played through ChessBoard, with
+ * and without a getStatus() call after every move. Games run to the ply limit
+ * or mate, so positions after a draw claim are measured too.
+ *
+ * Each move is picked from the legal move list and applied with makeMove,
+ * as a game server validating client moves would. Both loops replay the same
+ * move sequences, so the difference is the cost of getStatus(); the call is
+ * also timed on its own. A last loop shows what the check would cost by
+ * generating all legal moves instead.
+ *
+ * Usage: status_bench [games]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include "game.h"
+
+using namespace std;
+
+const int MAX_GAME_PLIES = 400;
+
+// Plays `games` random games; `check` runs after every move and may end the game
+template <typename Check>
+static double playGames(int games, uint64_t& plies, uint64_t& checksum, Check check) {
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    plies = 0;
+    checksum = 0;
+    auto start = chrono::steady_clock::now();
+    for (int g = 0; g < games; g++) {
+        ChessBoard board;
+        for (int ply = 0; ply < MAX_GAME_PLIES; ply++) {
+            MoveList moves;
+            generateLegalMoves(board.getState(), moves);
+            if (moves.size() == 0) {
+                break;
+            }
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            board.makeMove(moves[static_cast<int>(seed % moves.size())]);
+            plies++;
+            checksum += check(board);
+        }
+    }
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int games = (argc > 1) ? atoi(argv[1]) : 2000;
+
+    // Interleaved rounds, keeping each variant's best time, to ride out timer noise
+    uint64_t plies = 0, checksum = 0, ended = 0;
+    double baseline = 1e9, withStatus = 1e9, bruteForce = 1e9;
+    for (int round = 0; round < 5; round++) {
+        baseline = min(baseline, playGames(games, plies, checksum, [](const ChessBoard&) { return 0; }));
+        withStatus = min(withStatus, playGames(games, plies, ended, [](const ChessBoard& board) {
+            return board.getStatus() != GameStatus::IN_PROGRESS ? 1 : 0;
+        }));
+        bruteForce = min(bruteForce, playGames(games, plies, checksum, [](const ChessBoard& board) {
+            MoveList moves;
+            generateLegalMoves(board.getState(), moves);
+            return moves.size() == 0 ? 1 : 0;
+        }));
+    }
+
+    // The end-to-end difference is close to timer noise, so also time the call
+    // itself, in batches per position so clock reads do not dominate
+    const int BATCH = 32;
+    double statusSeconds = 0;
+    playGames(games, plies, checksum, [&](const ChessBoard& board) {
+        auto start = chrono::steady_clock::now();
+        int finished = 0;
+        for (int i = 0; i < BATCH; i++) {
+            finished += board.getStatus() != GameStatus::IN_PROGRESS;
+        }
+        statusSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        return finished;
+    });
+    double perCall = statusSeconds / (static_cast<double>(plies) * BATCH);
+
+    cout << games << " games, " << plies << " plies, " << ended << " of them in a finished position\n";
+    cout << fixed << setprecision(1);
+    cout << "  make-move loop          " << baseline * 1e9 / plies << " ns/ply\n";
+    cout << "  + getStatus()           " << withStatus * 1e9 / plies << " ns/ply  overhead "
+         << setprecision(2) << (withStatus / baseline - 1) * 100 << "%\n";
+    cout << setprecision(1);
+    cout << "  getStatus() alone       " << perCall * 1e9 << " ns/call  = "
+         << setprecision(2) << perCall / (baseline / plies) * 100 << "% of a ply\n";
+    cout << setprecision(1);
+    cout << "  + legal-move-list test  " << bruteForce * 1e9 / plies << " ns/ply  overhead "
+         << setprecision(2) << (bruteForce / baseline - 1) * 100 << "%\n";
+    return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * Endgame tablebases for king and queen, rook or pawn against a bare king.
+ *
+ * tb_gen builds each table by retrograde analysis and writes it as a flat
+ * byte array with one entry per (side to move, strong king, weak king,
+ * piece square), seen from the strong side: positions where black holds the
+ * extra piece are flipped top to bottom first. An entry is 0 for a draw,
+ * 255 for an impossible position and otherwise the distance to mate in
+ * plies plus one. Tables are mapped read-only, so a probe is one index
+ * computation and one byte load.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "mapped_file.h"
+#include "movegen.h"
+
+enum TBTable {
+    TB_KQK, TB_KRK, TB_KPK, TB_TABLES
+};
+
+const int TB_POSITIONS = 2 * 64 * 64 * 64;
+const uint8_t TB_DRAW = 0;
+const uint8_t TB_INVALID = 255;
+
+inline const char* tbName(int table) {
+    static const char* names[TB_TABLES] = { "KQK", "KRK", "KPK" };
+    return names[table];
+}
+
+inline PieceType tbPiece(int table) {
+    static const PieceType pieces[TB_TABLES] = { PieceType::QUEEN, PieceType::ROOK, PieceType::PAWN };
+    return pieces[table];
+}
+
+inline int tbIndex(bool strongToMove, int strongKing, int weakKing, int piece) {
+    return ((strongToMove ? 0 : 1) << 18) | (strongKing << 12) | (weakKing << 6) | piece;
+}
+
+// Which table covers a position and where; false for anything but K+Q/R/P vs K
+// without castling rights
+inline bool tbLocate(const BoardState& state, int& table, int& index) {
+    if (popCount(state.occupied) != 3 || state.castlingRights != 0) {
+        return false;
+    }
+    Bitboard kings = state.piecesOf(Color::WHITE, PieceType::KING) | state.piecesOf(Color::BLACK, PieceType::KING);
+    int square = lsb(state.occupied & ~kings);
+    PieceCode piece = state.pieceOn(square);
+    switch (pieceType(piece)) {
+        case PieceType::QUEEN: table = TB_KQK; break;
+        case PieceType::ROOK: table = TB_KRK; break;
+        case PieceType::PAWN: table = TB_KPK; break;
+        default: return false;
+    }
+    Color strong = pieceColor(piece);
+    int flip = (strong == Color::WHITE) ? 0 : 56;
+    index = tbIndex(state.sideToMove == strong, state.kingSquare(strong) ^ flip,
+                    state.kingSquare(opposite(strong)) ^ flip, square ^ flip);
+    return true;
+}
+
+struct TBResult {
+    int wdl = 0;      // +1 the side to move wins, 0 draw, -1 it loses
+    int plies = 0;    // Plies to mate when not a draw
+};
+
+class Tablebase {
+public:
+    // Maps KQK.tb, KRK.tb and KPK.tb from a directory; returns how many were found
+    int open(const std::string& directory) {
+        int found = 0;
+        for (int t = 0; t < TB_TABLES; t++) {
+            regions[t].reset();
+            std::string path = directory + "/" + tbName(t) + ".tb";
+            if (files[t].open(path) && files[t].size() == TB_POSITIONS) {
+                regions[t] = files[t].map(0, TB_POSITIONS, false);
+                found += regions[t] != nullptr;
+            }
+        }
+        return found;
+    }
+
+    bool probe(const BoardState& state, TBResult& result) const {
+        if (popCount(state.occupied) == 2) {
+            result = TBResult(); // Bare kings
+            return true;
+        }
+        int table, index;
+        if (!tbLocate(state, table, index) || !regions[table]) {
+            return false;
+        }
+        uint8_t value = static_cast<uint8_t>(regions[table]->data[index]);
+        if (value == TB_INVALID) {
+            return false;
+        }
+        result.wdl = (value == TB_DRAW) ? 0 : (index >> 18) ? -1 : 1;
+        result.plies = (value == TB_DRAW) ? 0 : value - 1;
+        return true;
+    }
+
+private:
+    MappedFile files[TB_TABLES];
+    std::shared_ptr<MappedRegion> regions[TB_TABLES];
+};
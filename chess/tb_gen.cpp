@@ -0,0 +1,156 @@
+/**
+ * Tablebase generator: builds KQK, KRK and KPK by retrograde analysis.
+ *
+ * Every index is set up as a position with white as the strong side.
+ * Checkmates are distance 0; pass k then marks strong-to-move positions
+ * with a move to a distance k-1 loss, and weak-to-move positions whose
+ * moves all reach wins no longer than k-1. Whatever is left when no pass
+ * changes anything is a draw. KPK is built last because promotions lead
+ * into the other two tables.
+ *
+ * Usage: tb_gen [output directory]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "tablebase.h"
+
+using namespace std;
+
+const int16_t INVALID = -1;
+const int16_t UNKNOWN = -2;
+const int16_t DRAW = -3;
+
+// Puts the position for `index` on `state`; false if it cannot occur
+static bool setup(int table, int index, BoardState& state) {
+    bool strongToMove = (index >> 18) == 0;
+    int strongKing = (index >> 12) & 63, weakKing = (index >> 6) & 63, piece = index & 63;
+    if (strongKing == weakKing || piece == strongKing || piece == weakKing) {
+        return false;
+    }
+    if (table == TB_KPK && (piece < 8 || piece >= 56)) {
+        return false;
+    }
+    state.clear();
+    state.addPiece(Color::WHITE, PieceType::KING, strongKing);
+    state.addPiece(Color::BLACK, PieceType::KING, weakKing);
+    state.addPiece(Color::WHITE, tbPiece(table), piece);
+    state.sideToMove = strongToMove ? Color::WHITE : Color::BLACK;
+    return !isInCheck(state, opposite(state.sideToMove));
+}
+
+// Distance of a position reached by a move: >= 0 for a decided position,
+// DRAW, or UNKNOWN while it is still being worked out
+static int16_t childValue(const BoardState& child, int table, const vector<int16_t>& work,
+                          const vector<vector<uint8_t>>& done) {
+    int childTable, index;
+    if (!tbLocate(child, childTable, index)) {
+        return DRAW; // Bare kings, or an underpromotion to a minor piece
+    }
+    if (childTable == table) {
+        return work[index];
+    }
+    uint8_t value = done[childTable][index];
+    return (value == TB_DRAW) ? DRAW : static_cast<int16_t>(value - 1);
+}
+
+static vector<uint8_t> generate(int table, const vector<vector<uint8_t>>& done) {
+    vector<int16_t> work(TB_POSITIONS, INVALID);
+    BoardState state;
+    MoveList moves;
+
+    // Pass 0: legal positions, checkmates and stalemates
+    for (int index = 0; index < TB_POSITIONS; index++) {
+        if (!setup(table, index, state)) {
+            continue;
+        }
+        generateLegalMoves(state, moves);
+        if (moves.size() > 0) {
+            work[index] = UNKNOWN;
+        } else {
+            work[index] = isInCheck(state, state.sideToMove) ? 0 : DRAW;
+        }
+    }
+
+    // Distances from other tables can be long, so keep going past quiet passes
+    int longestChild = 0;
+    for (const vector<uint8_t>& t : done) {
+        for (uint8_t value : t) {
+            if (value != TB_INVALID && value > longestChild) longestChild = value;
+        }
+    }
+    int lastChange = 0;
+    for (int k = 1; k < TB_INVALID - 1 && (k <= lastChange + 2 || k <= longestChild + 1); k++) {
+        bool strongPass = (k & 1) != 0; // Wins are odd distances, losses even
+        int first = strongPass ? 0 : TB_POSITIONS / 2;
+        for (int index = first; index < first + TB_POSITIONS / 2; index++) {
+            if (work[index] != UNKNOWN) {
+                continue;
+            }
+            setup(table, index, state);
+            generateLegalMoves(state, moves);
+            bool decided = !strongPass;
+            int longest = -1;
+            for (const Move& move : moves) {
+                UndoInfo undo;
+                state.makeMove(move, undo);
+                int16_t value = childValue(state, table, work, done);
+                state.unmakeMove(move, undo);
+                if (strongPass && value == k - 1) {
+                    decided = true; // A move to a lost position
+                    break;
+                }
+                if (!strongPass) {
+                    if (value < 0) {
+                        decided = false; // An escape to a draw or an open position
+                        break;
+                    }
+                    longest = max(longest, static_cast<int>(value));
+                }
+            }
+            if (decided && (strongPass || longest == k - 1)) {
+                work[index] = static_cast<int16_t>(k);
+                lastChange = k;
+            }
+        }
+    }
+
+    vector<uint8_t> values(TB_POSITIONS);
+    for (int index = 0; index < TB_POSITIONS; index++) {
+        int16_t v = work[index];
+        values[index] = (v == INVALID) ? TB_INVALID : (v < 0) ? TB_DRAW : static_cast<uint8_t>(v + 1);
+    }
+    return values;
+}
+
+int main(int argc, char* argv[]) {
+    string directory = (argc > 1) ? argv[1] : ".";
+    vector<vector<uint8_t>> done;
+    for (int table = 0; table < TB_TABLES; table++) {
+        auto start = chrono::steady_clock::now();
+        vector<uint8_t> values = generate(table, done);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        int wins = 0, draws = 0, longest = 0;
+        for (int index = 0; index < TB_POSITIONS / 2; index++) {
+            if (values[index] == TB_INVALID) continue;
+            if (values[index] == TB_DRAW) draws++;
+            else { wins++; longest = max(longest, values[index] - 1); }
+        }
+        cout << tbName(table) << ": " << wins << " wins, " << draws << " draws with the strong side to move, "
+             << "longest mate " << longest << " plies, " << seconds << "s\n";
+
+        string path = directory + "/" + tbName(table) + ".tb";
+        FILE* out = fopen(path.c_str(), "wb");
+        if (out == nullptr || fwrite(values.data(), 1, values.size(), out) != values.size() || fclose(out) != 0) {
+            cerr << "Cannot write " << path << "\n";
+            return 1;
+        }
+        done.push_back(std::move(values));
+    }
+    return 0;
+}
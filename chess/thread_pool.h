@@ -0,0 +1,156 @@
+/**
+ * Work-stealing thread pool.
+ *
+ * Every worker owns a deque. A worker pops its own newest task first (good
+ * cache locality) and, when its deque is empty, steals the oldest task from
+ * another worker. Tasks submitted from outside the pool are spread round-robin
+ * over the deques. Each deque has its own small lock, so workers only contend
+ * when they steal from each other.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(int threadCount) {
+        if (threadCount < 1) {
+            threadCount = 1;
+        }
+        for (int i = 0; i < threadCount; i++) {
+            queues.emplace_back(new WorkerQueue());
+        }
+        for (int i = 0; i < threadCount; i++) {
+            threads.emplace_back([this, i] { run(i); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        wait();
+        {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            stopping = true;
+        }
+        idleCv.notify_all();
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int size() const {
+        return static_cast<int>(threads.size());
+    }
+
+    void submit(Task task) {
+        // Tasks spawned by a worker stay on its own deque
+        size_t index = (workerIndex >= 0 && owner == this)
+                           ? static_cast<size_t>(workerIndex)
+                           : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+        unfinished.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(queues[index]->mutex);
+            queues[index]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            queued++;
+        }
+        idleCv.notify_one();
+    }
+
+    // Blocks until no more than `limit` submitted tasks are unfinished
+    void waitBelow(size_t limit) {
+        std::unique_lock<std::mutex> lock(doneMutex);
+        doneCv.wait(lock, [&] { return unfinished.load() <= limit; });
+    }
+
+    // Blocks until every submitted task has finished
+    void wait() {
+        waitBelow(0);
+    }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> nextQueue{0};
+    std::atomic<size_t> unfinished{0}; // Queued or running
+
+    std::mutex idleMutex;
+    std::condition_variable idleCv;
+    size_t queued = 0;                 // Guarded by idleMutex
+    bool stopping = false;             // Guarded by idleMutex
+
+    std::mutex doneMutex;
+    std::condition_variable doneCv;
+
+    // Which pool and deque the current thread works for, if any
+    static inline thread_local int workerIndex = -1;
+    static inline thread_local WorkStealingPool* owner = nullptr;
+
+    bool tryPop(int self, Task& task) {
+        {
+            WorkerQueue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+        int count = static_cast<int>(queues.size());
+        for (int i = 1; i < count; i++) {
+            WorkerQueue& victim = *queues[(self + i) % count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(int self) {
+        workerIndex = self;
+        owner = this;
+        while (true) {
+            Task task;
+            if (tryPop(self, task)) {
+                {
+                    std::lock_guard<std::mutex> lock(idleMutex);
+                    queued--;
+                }
+                task();
+                unfinished.fetch_sub(1);
+                {
+                    std::lock_guard<std::mutex> lock(doneMutex);
+                }
+                doneCv.notify_all();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(idleMutex);
+            idleCv.wait(lock, [&] { return queued > 0 || stopping; });
+            if (stopping && queued == 0) {
+                return;
+            }
+        }
+    }
+};
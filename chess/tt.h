@@ -0,0 +1,216 @@
+/**
+ * Shared transposition table.
+ *
+ * A fixed-size hash table of search results keyed by Zobrist hash, sized in
+ * megabytes and shared by every search thread without locks:
+ *
+ * - Entries are two 64-bit words: the packed data, and the key XOR-ed with
+ *   the data. A reader accepts an entry only if (stored key ^ data) equals
+ *   its own key, so an entry torn by a concurrent writer fails verification
+ *   and is treated as a miss instead of returning mixed data.
+ * - Four entries form a 64-byte cluster aligned to a cache line, so a probe
+ *   touches exactly one line.
+ * - Replacement prefers the same position, then empty or stale (older search
+ *   generation) entries, then the shallowest entry.
+ *
+ * Statistics are counted in a caller-owned TTStats so threads never share a
+ * counter cache line.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "bitboard.h"
+
+enum TTBound : uint8_t {
+    BOUND_NONE = 0,
+    BOUND_UPPER = 1,  // Failed low: score is at most this
+    BOUND_LOWER = 2,  // Failed high: score is at least this
+    BOUND_EXACT = 3
+};
+
+struct TTEntryData {
+    Move move;
+    int score = 0;
+    int depth = 0;
+    TTBound bound = BOUND_NONE;
+};
+
+struct TTStats {
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+    uint64_t stores = 0;
+    uint64_t collisions = 0; // Stores that evicted a different position from the current search
+
+    double hitRate() const {
+        return probes ? static_cast<double>(hits) / probes : 0;
+    }
+
+    void add(const TTStats& other) {
+        probes += other.probes;
+        hits += other.hits;
+        stores += other.stores;
+        collisions += other.collisions;
+    }
+};
+
+class TranspositionTable {
+private:
+    struct Entry {
+        std::atomic<uint64_t> keyXorData;
+        std::atomic<uint64_t> data;
+    };
+
+    static const int CLUSTER_SIZE = 4;
+
+    struct alignas(64) Cluster {
+        Entry entries[CLUSTER_SIZE];
+    };
+
+    std::unique_ptr<Cluster[]> clusters;
+    size_t clusterCount = 0;
+    std::atomic<uint8_t> generation{0};
+
+    // Data word layout: move (16) | unused (16) | score (16) | depth (8) | bound (2) | generation (6)
+    static uint64_t pack(const Move& move, int score, int depth, TTBound bound, uint8_t gen) {
+        return move.raw() | (static_cast<uint64_t>(static_cast<uint16_t>(score)) << 32) |
+               (static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 48) |
+               (static_cast<uint64_t>(bound) << 56) | (static_cast<uint64_t>(gen & 0x3F) << 58);
+    }
+
+    static Move unpackMove(uint64_t data) {
+        return Move::fromRaw(static_cast<uint16_t>(data & 0xFFFF));
+    }
+
+    static int unpackScore(uint64_t data) { return static_cast<int16_t>((data >> 32) & 0xFFFF); }
+    static int unpackDepth(uint64_t data) { return static_cast<int8_t>((data >> 48) & 0xFF); }
+    static TTBound unpackBound(uint64_t data) { return static_cast<TTBound>((data >> 56) & 0x3); }
+    static uint8_t unpackGeneration(uint64_t data) { return (data >> 58) & 0x3F; }
+
+    Cluster& clusterFor(uint64_t key) const {
+        return clusters[static_cast<size_t>(key) & (clusterCount - 1)];
+    }
+
+public:
+    explicit TranspositionTable(size_t megabytes = 16) {
+        resize(megabytes);
+    }
+
+    // Reallocates and clears the table, rounding down to a power-of-two
+    // cluster count so indexing is a mask. Not safe while a search is running.
+    void resize(size_t megabytes) {
+        size_t wanted = (megabytes * 1024 * 1024) / sizeof(Cluster);
+        clusterCount = 1;
+        while (clusterCount * 2 <= wanted) {
+            clusterCount *= 2;
+        }
+        clusters.reset(new Cluster[clusterCount]);
+        clear();
+    }
+
+    void clear() {
+        for (size_t i = 0; i < clusterCount; i++) {
+            for (Entry& e : clusters[i].entries) {
+                e.keyXorData.store(0, std::memory_order_relaxed);
+                e.data.store(0, std::memory_order_relaxed);
+            }
+        }
+        generation.store(0, std::memory_order_relaxed);
+    }
+
+    // Called once per new search so entries from older searches become replaceable
+    void newSearch() {
+        generation.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    size_t sizeInBytes() const {
+        return clusterCount * sizeof(Cluster);
+    }
+
+    bool probe(uint64_t key, TTEntryData& out, TTStats& stats) const {
+        stats.probes++;
+        Cluster& cluster = clusterFor(key);
+        for (Entry& e : cluster.entries) {
+            uint64_t data = e.data.load(std::memory_order_relaxed);
+            uint64_t check = e.keyXorData.load(std::memory_order_relaxed);
+            if ((check ^ data) == key && unpackBound(data) != BOUND_NONE) {
+                out.move = unpackMove(data);
+                out.score = unpackScore(data);
+                out.depth = unpackDepth(data);
+                out.bound = unpackBound(data);
+                stats.hits++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void store(uint64_t key, const Move& move, int score, int depth, TTBound bound, TTStats& stats) {
+        stats.stores++;
+        uint8_t gen = generation.load(std::memory_order_relaxed) & 0x3F;
+        Cluster& cluster = clusterFor(key);
+
+        Entry* replace = &cluster.entries[0];
+        int replaceWorth = 1 << 30;
+        for (Entry& e : cluster.entries) {
+            uint64_t data = e.data.load(std::memory_order_relaxed);
+            uint64_t storedKey = e.keyXorData.load(std::memory_order_relaxed) ^ data;
+            if (storedKey == key || unpackBound(data) == BOUND_NONE) {
+                replace = &e;
+                break;
+            }
+            // Entries from older searches are worth less than anything current
+            int worth = unpackDepth(data) - ((unpackGeneration(data) == gen) ? 0 : 256);
+            if (worth < replaceWorth) {
+                replaceWorth = worth;
+                replace = &e;
+            }
+        }
+
+        uint64_t old = replace->data.load(std::memory_order_relaxed);
+        uint64_t oldKey = replace->keyXorData.load(std::memory_order_relaxed) ^ old;
+        if (oldKey != key && unpackBound(old) != BOUND_NONE && unpackGeneration(old) == gen) {
+            stats.collisions++;
+        }
+        // Keep the old best move when the new result has none
+        Move best = (move.isNull() && oldKey == key) ? unpackMove(old) : move;
+
+        uint64_t data = pack(best, score, depth, bound, gen);
+        replace->data.store(data, std::memory_order_relaxed);
+        replace->keyXorData.store(key ^ data, std::memory_order_relaxed);
+    }
+
+    // Permille of sampled entries written during the current search
+    int hashfull() const {
+        uint8_t gen = generation.load(std::memory_order_relaxed) & 0x3F;
+        size_t samples = clusterCount < 250 ? clusterCount : 250;
+        int used = 0;
+        for (size_t i = 0; i < samples; i++) {
+            for (const Entry& e : clusters[i].entries) {
+                uint64_t data = e.data.load(std::memory_order_relaxed);
+                if (unpackBound(data) != BOUND_NONE && unpackGeneration(data) == gen) {
+                    used++;
+                }
+            }
+        }
+        return samples ? static_cast<int>(used * 1000 / (samples * CLUSTER_SIZE)) : 0;
+    }
+};
+
+// Mate scores are stored relative to the node, not the root, so they stay
+// correct when the same position is reached at a different ply
+inline int scoreToTT(int score, int ply, int mateBound) {
+    if (score >= mateBound) return score + ply;
+    if (score <= -mateBound) return score - ply;
+    return score;
+}
+
+inline int scoreFromTT(int score, int ply, int mateBound) {
+    if (score >= mateBound) return score - ply;
+    if (score <= -mateBound) return score + ply;
+    return score;
+}
@@ -0,0 +1,52 @@
+/**
+ * Zobrist keys for position hashing.
+ *
+ * A position's key is the XOR of one random 64-bit number per (color, piece,
+ * square) plus numbers for side to move, castling rights and en-passant file.
+ * Because XOR is its own inverse, a move updates the key by XOR-ing out what
+ * changed and XOR-ing in the new state, with no full-board rehash.
+ *
+ * Keys are generated at compile time from a fixed seed, so the same position
+ * hashes to the same value in every build and every process.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+struct ZobristKeys {
+    uint64_t piece[2][6][64];
+    uint64_t castling[16];   // Indexed by the full CastlingRight bit set
+    uint64_t enPassantFile[8];
+    uint64_t blackToMove;
+
+    constexpr ZobristKeys() : piece{}, castling{}, enPassantFile{}, blackToMove(0) {
+        uint64_t seed = 0x5A0B1575C0FFEE11ULL;
+        for (int c = 0; c < 2; c++) {
+            for (int t = 0; t < 6; t++) {
+                for (int sq = 0; sq < 64; sq++) {
+                    piece[c][t][sq] = splitMix(seed);
+                }
+            }
+        }
+        // The empty rights set hashes to zero so positions without castling
+        // rights do not need a term
+        for (int i = 1; i < 16; i++) {
+            castling[i] = splitMix(seed);
+        }
+        for (int f = 0; f < 8; f++) {
+            enPassantFile[f] = splitMix(seed);
+        }
+        blackToMove = splitMix(seed);
+    }
+
+private:
+    static constexpr uint64_t splitMix(uint64_t& seed) {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+inline constexpr ZobristKeys ZOBRIST{};
@@ -0,0 +1,103 @@
+/**
+ * Bounded lock-free queue after Dmitry Vyukov's array-based design.
+ *
+ * Every cell carries a sequence number that says whose turn it is: a
+ * producer may fill cell i when its sequence equals the enqueue position,
+ * a consumer may empty it when the sequence is one past that. Claiming a
+ * position is one CAS, after which the cell is private to the claimer, so
+ * any number of producers and consumers can work at once. Capacity is
+ * rounded up to a power of two.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        cells.reset(new Cell[size]);
+        mask = size - 1;
+        for (size_t i = 0; i < size; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // False when the queue is full; `value` is only moved from on success
+    template <typename U>
+    bool tryPush(U&& value) {
+        size_t position = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[position & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = std::forward<U>(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // The cell still holds a value from the previous lap
+            } else {
+                position = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // False when the queue is empty
+    bool tryPop(T& value) {
+        size_t position = dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[position & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    value = std::move(cell.value);
+                    cell.sequence.store(position + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+
+    // Approximate while pushes and pops are in flight
+    size_t size() const {
+        size_t tail = dequeuePos.load(std::memory_order_acquire);
+        size_t head = enqueuePos.load(std::memory_order_acquire);
+        return head > tail ? head - tail : 0;
+    }
+
+private:
+    // One cache line per cell, so neighbouring producers do not false-share
+    struct alignas(64) Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueuePos{ 0 };
+    alignas(64) std::atomic<size_t> dequeuePos{ 0 };
+};
@@ -1,14 +1,9 @@
+#include <chrono>
 #include <iostream>
-#include <vector>
+#include <thread>
+#include "publisher.h"
 using namespace std;
 
-// Observer (Subscriber) interface
-class Observer {
-public:
-    // Pure virtual function to update the observer with a message
-    virtual void update(const string& message) = 0;
-};
-
 // Concreate Observer class
 class ConcreteObserver : public Observer {
 public:
@@ -18,36 +13,23 @@ public:
     }
 };
 
-// Subject (Publisher) class
-class Publisher {
-private:
-    // List of observers
-    vector<Observer*> observers; 
-
+// Observer that takes a while over every message
+class SlowObserver : public Observer {
 public:
-    // Attach an observer to the publisher
-    void subscribe(Observer* observer) {
-        observers.push_back(observer);
-    }
+    int received = 0;
 
-    // Detach an observer from the publisher
-    void unsubscribe(Observer* observer) {
-        for(auto it = observers.begin(); it != observers.end(); ++it) {
-            if (*it == observer) {
-                observers.erase(it);
-                break;
-            }
-        }
-    }
-
-    void notify(const string& message) {
-        // Notify all observers with the message
-        for (Observer* observer : observers) {
-            observer->update(message);
-        }
+    void update(const string&) override {
+        this_thread::sleep_for(chrono::microseconds(200));
+        received++;
     }
 };
 
+static void printMetrics(const char* label, const QueueMetrics& m) {
+    cout << label << ": published " << m.published << ", delivered " << m.delivered
+         << ", dropped " << m.dropped << ", depth " << m.depth << "/" << m.capacity
+         << ", high water " << m.highWater << "\n";
+}
+
 int main() {
     Publisher publisher;
 
@@ -63,7 +45,24 @@ int main() {
     publisher.notify("Message 1");
     publisher.notify("Message 2");
 
-    return 0;
-}
+    // Asynchronous dispatch: the producer outruns a slow observer and the
+    // backpressure policy decides what gives
+    const Backpressure policies[] = { Backpressure::BLOCK, Backpressure::DROP_OLDEST, Backpressure::DROP_NEWEST };
+    const char* names[] = { "block", "drop-oldest", "drop-newest" };
+    for (int i = 0; i < 3; i++) {
+        SlowObserver slow;
+        AsyncPublisher async(64, policies[i]);
+        async.subscribe(&slow);
 
+        auto start = chrono::steady_clock::now();
+        for (int n = 0; n < 1000; n++) {
+            async.notify("Message " + to_string(n));
+        }
+        double publishMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        async.flush();
+        printMetrics(names[i], async.metrics());
+        cout << "  producer done in " << publishMs << " ms, slow observer got " << slow.received << "\n";
+    }
 
+    return 0;
+}
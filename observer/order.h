@@ -0,0 +1,344 @@
+/**
+ * Order status example: an Order is the subject, and customers,
+ * restaurants, drivers and the call center observe it.
+ *
+ * Orders notify their observers on every status change, or, when given a
+ * NotificationBatcher, leave it to the batcher to coalesce changes and
+ * hand each observer one batch per window. Observers end their lines with
+ * '\n' rather than endl and leave flushing to the stream buffer.
+ *
+ * An order keeps its status as a code in the shared orderStatuses() table,
+ * so setting a status allocates nothing once the status is known, and
+ * getStatus() hands out the interned name instead of a copy.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "status_table.h"
+#include "subscriber_registry.h"
+
+// Statuses of every Order
+inline StatusTable& orderStatuses() {
+    static StatusTable table;
+    return table;
+}
+
+class Order;
+
+class Observer {
+public:
+    virtual ~Observer() = default;
+
+    // Pure virtual function to update the observer with an order
+    virtual void update(Order* order) = 0;
+
+    // Several orders at once, each in its latest status
+    virtual void updateBatch(const std::vector<Order*>& orders) {
+        for (Order* order : orders) {
+            update(order);
+        }
+    }
+
+    // A status change in an OrderStore, which keeps records instead of
+    // Order objects. Observers that only watch Orders can ignore it.
+    virtual void statusChanged(int orderId, const std::string& status) {
+        (void)orderId;
+        (void)status;
+    }
+
+    // The same change as a code in the store's own table, whose names stay
+    // valid as long as the table does. Observers that hand the change on
+    // can keep the code instead of copying or re-interning the name.
+    virtual void statusCodeChanged(int orderId, uint16_t status, const StatusTable& table) {
+        statusChanged(orderId, table.name(status));
+    }
+};
+
+// An observer that handles every change in statusChanged, whether it comes
+// from an Order or an OrderStore
+class StatusObserver : public Observer {
+public:
+    void update(Order* order) override;
+
+    void statusChanged(int orderId, const std::string& status) override = 0;
+};
+
+class NotificationBatcher;
+
+// Subject: Order
+class Order {
+private:
+    int id;
+    uint16_t status; // Code in orderStatuses()
+    SubscriberRegistry<Observer> observers;
+    NotificationBatcher* batcher = nullptr;
+    bool queued = false; // Already waiting in the batcher
+
+    friend class NotificationBatcher;
+
+public:
+    Order(int id): id(id), status(orderStatuses().intern("Order Palced")) {}
+
+    // Leaves its batcher's pending changes, undelivered
+    inline ~Order();
+
+    int getId() const {
+        return id;
+    }
+
+    const std::string& getStatus() const {
+        return orderStatuses().name(status);
+    }
+
+    uint16_t getStatusCode() const {
+        return status;
+    }
+
+    // False, with the status unchanged and no one notified, once the table
+    // holds StatusTable::MAX_STATUSES other statuses
+    inline bool setStatus(std::string_view newStatus);
+
+    // Hands notifications to a batcher instead of sending them at once. A
+    // change still waiting in the old batcher is delivered now instead. The
+    // batcher must outlive the order, or be unset before it goes.
+    inline void setBatcher(NotificationBatcher* notificationBatcher);
+
+    void attach(Observer* observer) {
+        observers.add(observer);
+    }
+
+    // Assuming each observer can be attached only once
+    void detach(Observer* observer) {
+        observers.remove(observer);
+    }
+
+    void notifyObserver() {
+        observers.forEach([this](Observer* observer) {
+            observer->update(this);
+        });
+    }
+};
+
+// Coalesces status changes: an order changed several times within one
+// window is delivered once, in its latest status, and every observer gets
+// the window's orders in one updateBatch call. Used from one thread.
+//
+// There is no timer: a window is delivered when a change arrives after it
+// has passed, or when the owner calls poll() or flush(). An owner with an
+// event loop wakes at nextDeadline() and polls, so the last change before a
+// quiet period is not held back. Whatever is pending at destruction is
+// delivered then.
+class NotificationBatcher {
+public:
+    explicit NotificationBatcher(std::chrono::microseconds window) : window(window) {}
+
+    ~NotificationBatcher() {
+        flush();
+    }
+
+    NotificationBatcher(const NotificationBatcher&) = delete;
+    NotificationBatcher& operator=(const NotificationBatcher&) = delete;
+
+    void changed(Order* order) {
+        transitions++;
+        if (!order->queued) {
+            order->queued = true;
+            if (pending.empty()) {
+                windowStart = std::chrono::steady_clock::now();
+            }
+            pending.push_back(order);
+        }
+        poll();
+    }
+
+    // When poll() will next deliver; time_point::max() while nothing is pending
+    std::chrono::steady_clock::time_point nextDeadline() const {
+        if (pending.empty()) {
+            return std::chrono::steady_clock::time_point::max();
+        }
+        return windowStart + window;
+    }
+
+    // Delivers the pending changes if the window has passed
+    bool poll() {
+        if (pending.empty() || std::chrono::steady_clock::now() - windowStart < window) {
+            return false;
+        }
+        flush();
+        return true;
+    }
+
+    // Delivers the pending changes now, one batch per observer
+    void flush() {
+        std::vector<Order*> orders;
+        orders.swap(pending);
+        for (Order* order : orders) {
+            order->queued = false;
+            order->observers.forEach([&](Observer* observer) {
+                auto slot = batchIndex.emplace(observer, batches.size());
+                if (slot.second) {
+                    batches.emplace_back(observer, std::vector<Order*>());
+                }
+                batches[slot.first->second].second.push_back(order);
+            });
+        }
+        for (auto& batch : batches) {
+            batch.first->updateBatch(batch.second);
+        }
+        delivered += orders.size();
+        batches.clear();
+        batchIndex.clear();
+    }
+
+    // Drops an order's pending change, e.g. because the order is going away
+    void forget(Order* order) {
+        if (order->queued) {
+            order->queued = false;
+            pending.erase(std::find(pending.begin(), pending.end(), order));
+        }
+    }
+
+    uint64_t transitionCount() const {
+        return transitions;
+    }
+
+    // Order notifications sent, after coalescing
+    uint64_t deliveredCount() const {
+        return delivered;
+    }
+
+private:
+    std::chrono::microseconds window;
+    std::chrono::steady_clock::time_point windowStart;
+    std::vector<Order*> pending;
+    std::vector<std::pair<Observer*, std::vector<Order*>>> batches;
+    std::unordered_map<Observer*, size_t> batchIndex;
+    uint64_t transitions = 0, delivered = 0;
+};
+
+inline Order::~Order() {
+    if (batcher != nullptr) {
+        batcher->forget(this);
+    }
+}
+
+inline void Order::setBatcher(NotificationBatcher* notificationBatcher) {
+    if (batcher != nullptr && queued) {
+        batcher->forget(this);
+        notifyObserver();
+    }
+    batcher = notificationBatcher;
+}
+
+inline bool Order::setStatus(std::string_view newStatus) {
+    uint16_t code = orderStatuses().intern(newStatus);
+    if (code == StatusTable::NONE) {
+        return false;
+    }
+    status = code;
+    if (batcher != nullptr) {
+        batcher->changed(this);
+    } else {
+        notifyObserver();
+    }
+    return true;
+}
+
+inline void StatusObserver::update(Order* order) {
+    statusChanged(order->getId(), order->getStatus());
+}
+
+// Writes one notification line per order; a batch goes out in one write
+class LineObserver : public StatusObserver {
+public:
+    void updateBatch(const std::vector<Order*>& orders) override {
+        std::string lines;
+        for (Order* order : orders) {
+            format(lines, order->getId(), order->getStatus());
+        }
+        std::cout.write(lines.data(), static_cast<std::streamsize>(lines.size()));
+    }
+
+    void statusChanged(int orderId, const std::string& status) override {
+        std::string line;
+        format(line, orderId, status);
+        std::cout << line;
+    }
+
+protected:
+    // "<who> notified. Order ID: <id>, Status: <status>\n"
+    virtual void appendWho(std::string& out) const = 0;
+
+private:
+    void format(std::string& out, int orderId, const std::string& status) const {
+        appendWho(out);
+        out += " notified. Order ID: ";
+        out += std::to_string(orderId);
+        out += ", Status: ";
+        out += status;
+        out += '\n';
+    }
+};
+
+// Concrete Observer: Customer
+class Customer : public LineObserver {
+private:
+    std::string name;
+
+public:
+    Customer(const std::string& name): name(name) {}
+
+protected:
+    void appendWho(std::string& out) const override {
+        out += "Customer ";
+        out += name;
+    }
+};
+
+// Concrete Observer: Restaurant
+class Restaurant : public LineObserver {
+private:
+    std::string restaurantName;
+
+public:
+    Restaurant(const std::string& name): restaurantName(name) {}
+
+protected:
+    void appendWho(std::string& out) const override {
+        out += "Restaurant ";
+        out += restaurantName;
+    }
+};
+
+// Concrete Observer: DeliveryDriver
+class DeliveryDriver : public LineObserver {
+private:
+    std::string driverName;
+
+public:
+    DeliveryDriver(const std::string& name): driverName(name) {}
+
+protected:
+    void appendWho(std::string& out) const override {
+        out += "Delivery Driver ";
+        out += driverName;
+    }
+};
+
+// Concrete Observer: CallCenter
+class CallCenter : public LineObserver {
+protected:
+    void appendWho(std::string& out) const override {
+        out += "Call Center";
+    }
+};
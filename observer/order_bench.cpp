@@ -0,0 +1,123 @@
+/**
+ * Order status notification throughput: one line per observer and event
+ * flushed with endl (the original observers), the same lines left to the
+ * stream buffer, and batched delivery that coalesces each order's changes
+ * within a window.
+ *
+ * Every order has its own customer plus one of 10 restaurants, one of 50
+ * drivers and the call center. Each event moves a random order to its next
+ * status. Notifications go to stdout, results to stderr.
+ *
+ * Usage: order_bench [orders] [events] [window us] > /dev/null
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "order.h"
+using namespace std;
+
+const char* STATUSES[] = { "Order Placed", "Preparing", "Out for Delivery", "Delivered" };
+
+// The original observers: format straight to cout and flush every line
+class FlushingObserver : public Observer {
+public:
+    explicit FlushingObserver(const string& who) : who(who) {}
+
+    void update(Order* order) override {
+        cout << who << " notified. Order ID: " << order->getId()
+             << ", Status: " << order->getStatus() << endl;
+    }
+
+private:
+    string who;
+};
+
+struct Scenario {
+    vector<unique_ptr<Order>> orders;
+    vector<unique_ptr<Observer>> observers;
+};
+
+// `flushing` picks the original observers instead of the LineObserver ones
+static Scenario build(int orderCount, bool flushing) {
+    Scenario s;
+    auto make = [&](const string& kind, const string& name) -> Observer* {
+        if (flushing) {
+            s.observers.emplace_back(new FlushingObserver(kind.empty() ? name : kind + " " + name));
+        } else if (kind == "Customer") {
+            s.observers.emplace_back(new Customer(name));
+        } else if (kind == "Restaurant") {
+            s.observers.emplace_back(new Restaurant(name));
+        } else if (kind == "Delivery Driver") {
+            s.observers.emplace_back(new DeliveryDriver(name));
+        } else {
+            s.observers.emplace_back(new CallCenter());
+        }
+        return s.observers.back().get();
+    };
+    vector<Observer*> restaurants, drivers;
+    for (int i = 0; i < 10; i++) restaurants.push_back(make("Restaurant", "Restaurant " + to_string(i)));
+    for (int i = 0; i < 50; i++) drivers.push_back(make("Delivery Driver", "Driver " + to_string(i)));
+    Observer* callCenter = make("", "Call Center");
+    for (int i = 0; i < orderCount; i++) {
+        s.orders.emplace_back(new Order(i));
+        Order& order = *s.orders.back();
+        order.attach(make("Customer", "Customer " + to_string(i)));
+        order.attach(restaurants[i % restaurants.size()]);
+        order.attach(drivers[i % drivers.size()]);
+        order.attach(callCenter);
+    }
+    return s;
+}
+
+// Applies `events` status changes; returns the elapsed seconds
+static double run(Scenario& s, int events, NotificationBatcher* batcher) {
+    vector<uint8_t> stage(s.orders.size(), 0);
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < events; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        size_t index = seed % s.orders.size();
+        stage[index] = (stage[index] + 1) % 4;
+        s.orders[index]->setStatus(STATUSES[stage[index]]);
+    }
+    if (batcher != nullptr) {
+        batcher->flush();
+    }
+    cout.flush();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int orderCount = (argc > 1) ? atoi(argv[1]) : 1000;
+    int events = (argc > 2) ? atoi(argv[2]) : 200000;
+    long windowUs = (argc > 3) ? atol(argv[3]) : 1000;
+
+    Scenario flushing = build(orderCount, true);
+    double before = run(flushing, events, nullptr);
+
+    Scenario buffered = build(orderCount, false);
+    double unbatched = run(buffered, events, nullptr);
+
+    NotificationBatcher batcher{ chrono::microseconds(windowUs) }; // Outlives the orders using it
+    Scenario batched = build(orderCount, false);
+    for (auto& order : batched.orders) {
+        order->setBatcher(&batcher);
+    }
+    double after = run(batched, events, &batcher);
+
+    cerr << orderCount << " orders, 4 observers each, " << events << " status changes\n" << fixed << setprecision(0);
+    cerr << "  per event, endl            " << setw(10) << events / before << " events/s\n";
+    cerr << "  per event, buffered        " << setw(10) << events / unbatched << " events/s  "
+         << setprecision(1) << before / unbatched << "x\n" << setprecision(0);
+    cerr << "  batched, " << setw(5) << windowUs << " us window    " << setw(10) << events / after << " events/s  "
+         << setprecision(1) << before / after << "x, " << batcher.deliveredCount() << " order notifications\n";
+    return 0;
+}
@@ -0,0 +1,448 @@
+/**
+ * Durable, append-only log of order status changes in a memory-mapped file
+ * (POSIX mmap or Windows file mappings).
+ *
+ * Every change is one 8-byte record: order id, status code and a check
+ * derived from the record's sequence number, so a record is the word at
+ * offset 4096 + 8 * sequence and unwritten (zero) or torn words never pass
+ * as data. Status names live in the 4 KiB header. Appends are a fetch_add
+ * and a store, from any number of threads. An append that took a sequence
+ * but could not raise the file's limit leaves a tombstone there instead,
+ * which replay skips, so the records after it are not hidden.
+ *
+ * Nothing is durable until waitDurable() or sync(). Concurrent callers
+ * share one flush (group commit): whoever finds no flush running flushes
+ * every record written so far, the others wait for it. Recovery only
+ * rescans the records after the last checkpoint in the header, so reopening
+ * a large log stays quick.
+ *
+ * OrderLog is an Observer: attach it to orders, or subscribe it to an
+ * OrderStore, and replay() hands the log back to observers that missed it.
+ * One process writes a log at a time.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "order.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+class OrderLog : public Observer {
+public:
+    static const uint64_t NO_SEQUENCE = UINT64_MAX;
+    static const uint32_t MAX_STATUSES = 63;
+    static const size_t MAX_STATUS_LENGTH = 62;
+
+    OrderLog() = default;
+
+    ~OrderLog() {
+        close();
+    }
+
+    OrderLog(const OrderLog&) = delete;
+    OrderLog& operator=(const OrderLog&) = delete;
+
+    // Opens or creates a log; `capacity` (records) only applies to a new
+    // file, which is created sparse at its full size.
+    bool open(const std::string& path, uint64_t capacity = 1ULL << 26) {
+        close();
+        bool created = false;
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_ALWAYS,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER length;
+        GetFileSizeEx(file, &length);
+        uint64_t bytes = static_cast<uint64_t>(length.QuadPart);
+        if (bytes == 0) {
+            created = true;
+            bytes = HEADER_BYTES + capacity * sizeof(uint64_t);
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(bytes >> 32),
+                                     static_cast<DWORD>(bytes & 0xFFFFFFFF), nullptr);
+        base = mapping ? static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, 0)) : nullptr;
+        if (base == nullptr) {
+            close();
+            return false;
+        }
+#else
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0) {
+            close();
+            return false;
+        }
+        uint64_t bytes = static_cast<uint64_t>(st.st_size);
+        if (bytes == 0) {
+            created = true;
+            bytes = HEADER_BYTES + capacity * sizeof(uint64_t);
+            if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+                close();
+                return false;
+            }
+        }
+        void* view = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (view == MAP_FAILED) {
+            close();
+            return false;
+        }
+        base = static_cast<char*>(view);
+        pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+        mappedBytes = bytes;
+        if (bytes < HEADER_BYTES || !(created ? initialize(bytes) : recover(bytes))) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // Syncs what was written, then unmaps
+    void close() {
+        if (header != nullptr) {
+            sync();
+        }
+        if (base != nullptr) {
+#ifdef _WIN32
+            UnmapViewOfFile(base);
+#else
+            munmap(base, mappedBytes);
+#endif
+        }
+#ifdef _WIN32
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+#endif
+        base = nullptr;
+        header = nullptr;
+        records = nullptr;
+        next = 0;
+        written = 0;
+        writable = 0;
+        statusCount = 0;
+        durable = 0;
+    }
+
+    bool isOpen() const {
+        return base != nullptr;
+    }
+
+    // Sequence number of the new record; NO_SEQUENCE if the log is full, the
+    // status table is full or the status is longer than MAX_STATUS_LENGTH
+    uint64_t append(int orderId, const std::string& status) {
+        uint32_t code = codeOf(status);
+        if (code == MAX_STATUSES) {
+            return NO_SEQUENCE;
+        }
+        uint64_t sequence = next.fetch_add(1, std::memory_order_relaxed);
+        if (sequence >= writable.load(std::memory_order_acquire) && !raiseLimit(sequence)) {
+            if (sequence < capacity) {
+                // Visible once a later raise succeeds, instead of a hole end() never passes
+                records[sequence].store(pack(sequence, orderId, TOMBSTONE), std::memory_order_release);
+            }
+            return NO_SEQUENCE;
+        }
+        records[sequence].store(pack(sequence, orderId, code), std::memory_order_release);
+        return sequence;
+    }
+
+    void update(Order* order) override {
+        append(order->getId(), order->getStatus());
+    }
+
+    void statusChanged(int orderId, const std::string& status) override {
+        append(orderId, status);
+    }
+
+    // One past the last record of the unbroken written prefix. A record
+    // still being appended hides the ones after it until it lands.
+    uint64_t end() {
+        uint64_t at = written.load(std::memory_order_acquire);
+        uint64_t from = at;
+        uint64_t limit = writable.load(std::memory_order_acquire);
+        while (at < limit && valid(at, records[at].load(std::memory_order_acquire))) {
+            at++;
+        }
+        while (at > from && !written.compare_exchange_weak(from, at, std::memory_order_acq_rel)) {
+            if (from >= at) return from;
+        }
+        return at;
+    }
+
+    // Records before this survive a crash
+    uint64_t durableEnd() const {
+        std::lock_guard<std::mutex> lock(syncMutex);
+        return durable;
+    }
+
+    // Blocks until a record append() returned is on disk, flushing if no
+    // one else is
+    bool waitDurable(uint64_t sequence) {
+        std::unique_lock<std::mutex> lock(syncMutex);
+        while (durable <= sequence) {
+            if (flushing) {
+                synced.wait(lock);
+                continue;
+            }
+            flushing = true;
+            uint64_t from = durable;
+            lock.unlock();
+            uint64_t to = end();
+            bool ok = to == from || flushRecords(from, to);
+            if (ok && to > from) {
+                header->checkpoint.store(to, std::memory_order_release);
+                flushHeader(false);
+                commits.fetch_add(1, std::memory_order_relaxed);
+            }
+            lock.lock();
+            flushing = false;
+            if (ok) durable = to;
+            synced.notify_all();
+            if (!ok) {
+                return false;
+            }
+            if (to == from) {
+                // An earlier append has not landed yet
+                lock.unlock();
+                std::this_thread::yield();
+                lock.lock();
+            }
+        }
+        return true;
+    }
+
+    // Makes everything written so far durable
+    bool sync() {
+        uint64_t last = end();
+        return last == 0 || waitDurable(last - 1);
+    }
+
+    // Hands records [from, end()) to the observer; returns where to resume.
+    // Tombstones are skipped.
+    uint64_t replay(uint64_t from, Observer& observer) {
+        return scan(from, [&](uint64_t, int orderId, const std::string& status) {
+            observer.statusChanged(orderId, status);
+        });
+    }
+
+    // Calls visit(sequence, orderId, status) for records [from, end()),
+    // tombstones left out
+    template <typename Visit>
+    uint64_t scan(uint64_t from, Visit&& visit) {
+        uint64_t to = end();
+        for (uint64_t sequence = from; sequence < to; sequence++) {
+            uint64_t record = records[sequence].load(std::memory_order_acquire);
+            uint32_t code = record >> 32 & 0xFFFF;
+            if (code != TOMBSTONE) {
+                visit(sequence, static_cast<int>(static_cast<uint32_t>(record)), names[code]);
+            }
+        }
+        return std::max(from, to);
+    }
+
+    // Group commits so far, to compare with the records they covered
+    uint64_t commitCount() const {
+        return commits.load(std::memory_order_relaxed);
+    }
+
+private:
+    static const size_t HEADER_BYTES = 4096;
+    static const uint64_t LIMIT_STEP = 1 << 20; // Records between header syncs on the append path
+    static constexpr char MAGIC[8] = { 'O', 'R', 'D', 'E', 'R', 'L', 'O', 'G' };
+    static const uint32_t VERSION = 1;
+    static const uint32_t TOMBSTONE = 0xFFFF; // Status code of a sequence whose append failed
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t statusCount;
+        uint64_t capacity;
+        std::atomic<uint64_t> checkpoint; // Records before it were flushed
+        std::atomic<uint64_t> limit;      // No record at or past it was ever written
+        char statuses[MAX_STATUSES][MAX_STATUS_LENGTH + 2]; // Length byte, then the name
+    };
+    static_assert(sizeof(Header) <= HEADER_BYTES, "status names must fit in the header");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "records are stored as atomic words");
+
+    char* base = nullptr;
+    uint64_t mappedBytes = 0;
+    uint64_t pageSize = 4096;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+    Header* header = nullptr;
+    std::atomic<uint64_t>* records = nullptr;
+    uint64_t capacity = 0;
+
+    std::atomic<uint64_t> next{ 0 };    // Next sequence to hand out
+    std::atomic<uint64_t> written{ 0 }; // Cached end()
+    std::atomic<uint64_t> writable{ 0 }; // The header's limit, once it is on disk
+    std::atomic<uint64_t> commits{ 0 };
+
+    std::string names[MAX_STATUSES];         // Set before statusCount publishes them
+    std::atomic<uint32_t> statusCount{ 0 };
+    std::mutex headerMutex; // New statuses and limit raises
+
+    mutable std::mutex syncMutex;
+    std::condition_variable synced;
+    uint64_t durable = 0;
+    bool flushing = false;
+
+    static uint64_t check(uint64_t sequence, uint64_t payload) {
+        uint64_t h = (sequence + 1) * 0x9E3779B97F4A7C15ULL ^ payload * 0xC2B2AE3D27D4EB4FULL;
+        h ^= h >> 29;
+        h *= 0xBF58476D1CE4E5B9ULL;
+        return (h >> 48) | 1; // Never zero, so a zeroed word is never a record
+    }
+
+    // Bits 0-31 order id, 32-47 status code, 48-63 check
+    static uint64_t pack(uint64_t sequence, int orderId, uint32_t code) {
+        uint64_t payload = static_cast<uint32_t>(orderId) | static_cast<uint64_t>(code) << 32;
+        return payload | check(sequence, payload) << 48;
+    }
+
+    bool valid(uint64_t sequence, uint64_t record) const {
+        uint64_t payload = record & 0xFFFFFFFFFFFFULL;
+        uint64_t code = payload >> 32;
+        return record >> 48 == check(sequence, payload) &&
+               (code < statusCount.load(std::memory_order_acquire) || code == TOMBSTONE);
+    }
+
+    bool initialize(uint64_t bytes) {
+        header = reinterpret_cast<Header*>(base);
+        records = reinterpret_cast<std::atomic<uint64_t>*>(base + HEADER_BYTES);
+        capacity = (bytes - HEADER_BYTES) / sizeof(uint64_t);
+        std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+        header->version = VERSION;
+        header->capacity = capacity;
+        return flushHeader(true);
+    }
+
+    // Finds the end of the log from the checkpoint and clears anything a
+    // crash may have left past it
+    bool recover(uint64_t bytes) {
+        header = reinterpret_cast<Header*>(base);
+        records = reinterpret_cast<std::atomic<uint64_t>*>(base + HEADER_BYTES);
+        capacity = (bytes - HEADER_BYTES) / sizeof(uint64_t);
+        if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+            header->capacity != capacity || header->statusCount > MAX_STATUSES) {
+            return false;
+        }
+        for (uint32_t code = 0; code < header->statusCount; code++) {
+            names[code].assign(header->statuses[code] + 1, static_cast<unsigned char>(header->statuses[code][0]));
+        }
+        statusCount.store(header->statusCount, std::memory_order_release);
+        uint64_t limit = std::min(capacity, header->limit.load(std::memory_order_relaxed));
+        uint64_t at = std::min(header->checkpoint.load(std::memory_order_relaxed), limit);
+        while (at < limit && valid(at, records[at].load(std::memory_order_relaxed))) {
+            at++;
+        }
+        for (uint64_t stale = at; stale < limit; stale++) {
+            records[stale].store(0, std::memory_order_relaxed);
+        }
+        if (at < limit && !flushRecords(at, limit)) {
+            return false;
+        }
+        writable.store(limit, std::memory_order_relaxed);
+        next.store(at, std::memory_order_relaxed);
+        written.store(at, std::memory_order_relaxed);
+        durable = at;
+        return true;
+    }
+
+    uint32_t codeOf(const std::string& status) {
+        uint32_t count = statusCount.load(std::memory_order_acquire);
+        for (uint32_t code = 0; code < count; code++) {
+            if (names[code] == status) return code;
+        }
+        if (status.size() > MAX_STATUS_LENGTH) {
+            return MAX_STATUSES;
+        }
+        std::lock_guard<std::mutex> lock(headerMutex);
+        for (uint32_t code = count; code < statusCount.load(std::memory_order_relaxed); code++) {
+            if (names[code] == status) return code;
+        }
+        uint32_t code = statusCount.load(std::memory_order_relaxed);
+        if (code == MAX_STATUSES) {
+            return MAX_STATUSES;
+        }
+        // On disk before any record that uses it
+        header->statuses[code][0] = static_cast<char>(status.size());
+        std::memcpy(header->statuses[code] + 1, status.data(), status.size());
+        header->statusCount = code + 1;
+        if (!flushHeader(true)) {
+            header->statusCount = code;
+            return MAX_STATUSES;
+        }
+        names[code] = status;
+        statusCount.store(code + 1, std::memory_order_release);
+        return code;
+    }
+
+    // Records up to the limit may be written, so recovery clears past the
+    // end only up to it; it is raised on disk before anyone writes beyond
+    bool raiseLimit(uint64_t sequence) {
+        std::lock_guard<std::mutex> lock(headerMutex);
+        uint64_t limit = writable.load(std::memory_order_relaxed);
+        if (sequence < limit) {
+            return true;
+        }
+        if (sequence >= capacity) {
+            return false;
+        }
+        uint64_t raised = std::min(capacity, sequence + LIMIT_STEP);
+        header->limit.store(raised, std::memory_order_relaxed);
+        if (!flushHeader(true)) {
+            header->limit.store(limit, std::memory_order_relaxed);
+            return false;
+        }
+        writable.store(raised, std::memory_order_release);
+        return true;
+    }
+
+    bool flushRecords(uint64_t from, uint64_t to) {
+        uint64_t start = HEADER_BYTES + from * sizeof(uint64_t);
+        uint64_t stop = HEADER_BYTES + to * sizeof(uint64_t);
+        return flushBytes(start, stop - start, true);
+    }
+
+    // A checkpoint may reach the disk later; a new status or limit may not
+    bool flushHeader(bool wait) {
+        return flushBytes(0, HEADER_BYTES, wait);
+    }
+
+    bool flushBytes(uint64_t offset, uint64_t length, bool wait) {
+#ifdef _WIN32
+        return FlushViewOfFile(base + offset, static_cast<SIZE_T>(length)) && (!wait || FlushFileBuffers(file));
+#else
+        uint64_t aligned = offset - offset % pageSize;
+        return msync(base + aligned, length + (offset - aligned), wait ? MS_SYNC : MS_ASYNC) == 0;
+#endif
+    }
+};
@@ -0,0 +1,109 @@
+/**
+ * OrderLog throughput and recovery: appends from several threads without
+ * syncing, then with group commit (every writer waits for its batch to be
+ * durable), then reopens the log and replays it into an observer.
+ *
+ * Usage: order_log_bench [events] [threads] [batch] [log file]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "order_log.h"
+using namespace std;
+
+const string STATUSES[] = { "Order Placed", "Preparing", "Out for Delivery", "Delivered" };
+
+class CountingObserver : public Observer {
+public:
+    void update(Order*) override {}
+
+    void statusChanged(int orderId, const string&) override {
+        received++;
+        idSum += static_cast<uint64_t>(orderId);
+    }
+
+    uint64_t received = 0, idSum = 0;
+};
+
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Each thread appends `perThread` events; batch 0 never waits for the disk
+static double appendAll(OrderLog& log, int threads, int perThread, int batch) {
+    vector<thread> workers;
+    auto start = chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < perThread; i++) {
+                int id = t * perThread + i;
+                uint64_t sequence = log.append(id, STATUSES[id % 4]);
+                if (batch > 0 && (i + 1) % batch == 0) {
+                    log.waitDurable(sequence);
+                }
+            }
+        });
+    }
+    for (thread& w : workers) {
+        w.join();
+    }
+    log.sync();
+    return secondsSince(start);
+}
+
+int main(int argc, char* argv[]) {
+    int events = (argc > 1) ? atoi(argv[1]) : 4000000;
+    int threads = (argc > 2) ? atoi(argv[2]) : 4;
+    int batch = (argc > 3) ? atoi(argv[3]) : 256;
+    string path = (argc > 4) ? argv[4] : "order_log_bench.log";
+    int perThread = events / threads;
+    events = perThread * threads;
+
+    remove(path.c_str());
+    OrderLog log;
+    if (!log.open(path, 4ULL * events)) {
+        cerr << "cannot open " << path << "\n";
+        return 1;
+    }
+    cout << fixed << setprecision(2);
+    double unsynced = appendAll(log, threads, perThread, 0);
+    cout << events << " events from " << threads << " threads, 8 bytes each\n";
+    cout << "  no sync until the end     " << events / unsynced / 1e6 << " M events/s\n";
+
+    uint64_t commitsBefore = log.commitCount();
+    double grouped = appendAll(log, threads, perThread, batch);
+    uint64_t commits = log.commitCount() - commitsBefore;
+    cout << "  durable every " << setw(5) << batch << " each  " << events / grouped / 1e6 << " M events/s, "
+         << commits << " flushes, " << setprecision(0) << double(events) / max<uint64_t>(commits, 1)
+         << " events per flush\n" << setprecision(2);
+    uint64_t total = log.end();
+    log.close();
+
+    auto start = chrono::steady_clock::now();
+    if (!log.open(path)) {
+        cerr << "cannot reopen " << path << "\n";
+        return 1;
+    }
+    double reopen = secondsSince(start);
+    CountingObserver late;
+    start = chrono::steady_clock::now();
+    uint64_t resume = log.replay(0, late);
+    double replaySeconds = secondsSince(start);
+    cout << "  reopened in " << setprecision(3) << reopen * 1e3 << " ms, " << resume << " of " << total
+         << " records; replay " << setprecision(2) << late.received / replaySeconds / 1e6 << " M events/s\n";
+
+    CountingObserver tail;
+    log.replay(resume - 1000, tail);
+    cout << "  replay from " << resume - 1000 << ": " << tail.received << " events\n";
+    log.close();
+    remove(path.c_str());
+    return resume == total && late.received == total ? 0 : 1;
+}
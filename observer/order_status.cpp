@@ -1,119 +1,19 @@
+/**
+ * Order status demo: observers of single orders, a durable event log that a
+ * late observer replays, and batched delivery.
+ *
+ * Usage: order_status [log file]   (a file in the temporary directory by default)
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
 #include <iostream>
-#include <vector>
+#include <string>
+#include "order_log.h"
 using namespace std;
 
-class Order;
-
-class Observer {
-public:
-    // Pure virtual function to update the observer with an order
-    virtual void update(Order* order) = 0;
-};
-
-// Concrete Observer: Customer
-class Customer : public Observer {
-private:
-    string name;
-
-public:
-    Customer(const string& name): name(name) {}
-
-    void update(Order* order);
-};
-
-// Concrete Observer: Restaurant
-class Restaurant : public Observer {
-private:
-    string restaurantName;
-
-public:
-    Restaurant(const string& name): restaurantName(name) {}
-
-    void update(Order* order);
-};
-
-
-// Concrete Observer: DeliveryDriver
-class DeliveryDriver : public Observer {
-private:
-    string driverName;
-
-public:
-    DeliveryDriver(const string& name): driverName(name) {}
-    void update(Order* order);
-};
-
-// Concrete Observer: CallCenter
-class CallCenter : public Observer {
-public:
-    void update(Order* order);
-};
-
-// Subject: Order
-class Order {
-private:
-    int id;
-    string status;
-    vector<Observer*> observers;
-
-public:
-    Order(int id): id(id), status("Order Palced") {}
-
-    int getId() const {
-        return id;
-    }
-
-    string getStatus() const {
-        return status;
-    }
-
-    void setStatus(const string& newStatus) {
-        status = newStatus;
-        notifyObserver();
-    }
-
-    void attach(Observer* observer) {
-        observers.push_back(observer);
-    }
-
-    void detach(Observer* observer) {
-        for (auto it = observers.begin(); it != observers.end(); ++it) {
-            if (*it == observer) {
-                observers.erase(it);
-                // Assuming each observer can be attached only once
-                break;
-            }
-        }
-    }
-
-    void notifyObserver() {
-        for (Observer* observer : observers) {
-            observer->update(this);
-        }
-    }
-};
-
-void Customer::update(Order* order) {
-    cout << "Customer " << name << " notified. Order ID: " << order->getId() 
-         << ", Status: " << order->getStatus() << endl;
-}
-
-void Restaurant::update(Order* order) {
-    cout << "Restaurant " << restaurantName << " notified. Order ID: " << order->getId() 
-         << ", Status: " << order->getStatus() << endl;
-}
-
-void DeliveryDriver::update(Order* order) {
-    cout << "Delivery Driver " << driverName << " notified. Order ID: " << order->getId() 
-         << ", Status: " << order->getStatus() << endl;
-}
-
-void CallCenter::update(Order* order) {
-    cout << "Call Center notified. Order ID: " << order->getId() 
-         << ", Status: " << order->getStatus() << endl;
-}
-
-int main() {
+int main(int argc, char* argv[]) {
     // Create an order
     Order order1(123);
 
@@ -123,6 +23,14 @@ int main() {
     DeliveryDriver driver1("Driver 1");
     CallCenter callCenter;
 
+    // Record every change in a durable log
+    string path = (argc > 1) ? argv[1] : (filesystem::temp_directory_path() / "order_events.log").string();
+    remove(path.c_str());
+    OrderLog log;
+    if (log.open(path, 1 << 16)) {
+        order1.attach(&log);
+    }
+
     // Attach observers to the order
     order1.attach(&customer1);
     order1.attach(&restaurant1);
@@ -138,5 +46,30 @@ int main() {
     // Simulate more order status updates
     order1.setStatus("Delivered");
 
+    // A driver who joins late catches up from the log
+    DeliveryDriver driver2("Driver 2");
+    log.sync();
+    log.replay(0, driver2);
+    order1.detach(&log);
+    log.close();
+    remove(path.c_str());
+
+    // Batched delivery: rapid changes within the window are coalesced, and
+    // each observer gets one batch with every order in its latest status
+    NotificationBatcher batcher(chrono::milliseconds(50));
+    Order order2(124), order3(125);
+    for (Order* order : { &order2, &order3 }) {
+        order->attach(&customer1);
+        order->attach(&driver1);
+        order->setBatcher(&batcher);
+    }
+    order2.setStatus("Preparing");
+    order3.setStatus("Preparing");
+    order2.setStatus("Out for Delivery");
+    order2.setStatus("Delivered");
+    batcher.flush();
+    cout << batcher.transitionCount() << " status changes, " << batcher.deliveredCount()
+         << " order notifications after coalescing\n";
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,327 @@
+/**
+ * In-memory store for millions of orders, updated from many threads.
+ *
+ * Orders are not Order objects here but 12-byte records in open-addressing
+ * hash tables, split over lock-striped shards by order id. Each shard also
+ * indexes its orders by status, so "all orders out for delivery" is a walk
+ * over matching ids. Status strings are interned into small codes once.
+ *
+ * Subscriptions live in the store instead of in every order: observers of
+ * all orders in one SubscriberRegistry, observers of single orders in a
+ * registry of their own kept in the order's shard, so an order nobody
+ * watches costs no subscriber list at all. Either way an observer is not
+ * called any more once unsubscribe or detach has returned (unless it
+ * detaches itself from inside a call). Observers are called after the
+ * shard lock is released, through Observer::statusCodeChanged with the
+ * store's own status table (which falls back to statusChanged). Two
+ * threads updating the same order at once may deliver their notifications
+ * in either order.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "order.h"
+#include "status_table.h"
+#include "subscriber_registry.h"
+
+class OrderStore {
+public:
+    // The shard count is rounded up to a power of two
+    explicit OrderStore(size_t shardCount = 64) {
+        size_t count = 1;
+        while (count < shardCount) {
+            count *= 2;
+        }
+        shards.reset(new Shard[count]);
+        shardMask = count - 1;
+    }
+
+    OrderStore(const OrderStore&) = delete;
+    OrderStore& operator=(const OrderStore&) = delete;
+
+    // False if the id is already stored
+    bool add(int id, const std::string& status = "Order Palced") {
+        uint16_t code = statuses.intern(status);
+        if (code == StatusTable::NONE) {
+            return false;
+        }
+        Shard& shard = shardOf(id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.find(id) != nullptr) {
+            return false;
+        }
+        shard.insert(id, code);
+        return true;
+    }
+
+    bool remove(int id) {
+        Shard& shard = shardOf(id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Record* record = shard.find(id);
+        if (record == nullptr) {
+            return false;
+        }
+        shard.unindex(*record);
+        shard.erase(record);
+        shard.watchers.erase(id);
+        return true;
+    }
+
+    // False if the order is not stored. Observers hear about it afterwards.
+    bool setStatus(int id, const std::string& status) {
+        uint16_t code = statuses.intern(status);
+        if (code == StatusTable::NONE) {
+            return false;
+        }
+        Shard& shard = shardOf(id);
+        std::shared_ptr<SubscriberRegistry<Observer>> watchers;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            Record* record = shard.find(id);
+            if (record == nullptr) {
+                return false;
+            }
+            if (record->status != code) {
+                shard.unindex(*record);
+                record->status = code;
+                shard.index(*record);
+            }
+            auto watched = shard.watchers.find(id);
+            if (watched != shard.watchers.end()) {
+                watchers = watched->second;
+            }
+        }
+        auto call = [&](Observer* observer) {
+            observer->statusCodeChanged(id, code, statuses);
+        };
+        everyOrder.forEach(call);
+        if (watchers != nullptr) {
+            watchers->forEach(call);
+        }
+        return true;
+    }
+
+    bool getStatus(int id, std::string& status) const {
+        const Shard& shard = shardOf(id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const Record* record = shard.find(id);
+        if (record == nullptr) {
+            return false;
+        }
+        status = statuses.name(record->status);
+        return true;
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (size_t i = 0; i <= shardMask; i++) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            total += shards[i].count;
+        }
+        return total;
+    }
+
+    size_t countWithStatus(const std::string& status) const {
+        uint16_t code = statuses.find(status);
+        size_t total = 0;
+        for (size_t i = 0; code != StatusTable::NONE && i <= shardMask; i++) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            if (code < shards[i].byStatus.size()) total += shards[i].byStatus[code].size();
+        }
+        return total;
+    }
+
+    // Ids of the orders in a status, shard by shard
+    std::vector<int> ordersWithStatus(const std::string& status) const {
+        uint16_t code = statuses.find(status);
+        std::vector<int> ids;
+        for (size_t i = 0; code != StatusTable::NONE && i <= shardMask; i++) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            if (code < shards[i].byStatus.size()) {
+                ids.insert(ids.end(), shards[i].byStatus[code].begin(), shards[i].byStatus[code].end());
+            }
+        }
+        return ids;
+    }
+
+    // Observers of every order
+    void subscribe(Observer* observer) {
+        everyOrder.add(observer);
+    }
+
+    void unsubscribe(Observer* observer) {
+        everyOrder.remove(observer);
+    }
+
+    // Observers of one order, kept in its shard; false if it is not stored.
+    // The order keeps its registry, empty or not, until it is removed.
+    bool attach(int id, Observer* observer) {
+        std::shared_ptr<SubscriberRegistry<Observer>> watchers;
+        {
+            Shard& shard = shardOf(id);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (shard.find(id) == nullptr) {
+                return false;
+            }
+            std::shared_ptr<SubscriberRegistry<Observer>>& slot = shard.watchers[id];
+            if (slot == nullptr) {
+                slot = std::make_shared<SubscriberRegistry<Observer>>();
+            }
+            watchers = slot;
+        }
+        // Registry writes wait for a grace period, so never under the lock
+        watchers->add(observer);
+        return true;
+    }
+
+    bool detach(int id, Observer* observer) {
+        std::shared_ptr<SubscriberRegistry<Observer>> watchers;
+        {
+            Shard& shard = shardOf(id);
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto watched = shard.watchers.find(id);
+            if (watched == shard.watchers.end()) {
+                return false;
+            }
+            watchers = watched->second;
+        }
+        return watchers->remove(observer);
+    }
+
+    // Bytes held by the tables and indexes, not counting per-order observers
+    size_t memoryUsage() const {
+        size_t bytes = sizeof(*this) + (shardMask + 1) * sizeof(Shard);
+        for (size_t i = 0; i <= shardMask; i++) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            bytes += shards[i].slots.capacity() * sizeof(Record);
+            for (const std::vector<int>& ids : shards[i].byStatus) {
+                bytes += ids.capacity() * sizeof(int);
+            }
+        }
+        return bytes;
+    }
+
+private:
+    struct Record {
+        int id;
+        uint16_t status;   // StatusTable::NONE marks an empty slot
+        uint32_t position; // Index in the shard's byStatus[status]
+    };
+
+    // One lock stripe: a linear-probing table and its status index
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::vector<Record> slots;
+        size_t count = 0;
+        std::vector<std::vector<int>> byStatus;
+        // Shared with any setStatus still calling them after remove
+        std::unordered_map<int, std::shared_ptr<SubscriberRegistry<Observer>>> watchers;
+
+        static size_t home(int id, size_t mask) {
+            uint64_t h = static_cast<uint32_t>(id) * 0x9E3779B97F4A7C15ULL;
+            return static_cast<size_t>(h >> 32) & mask;
+        }
+
+        Record* find(int id) {
+            return const_cast<Record*>(static_cast<const Shard*>(this)->find(id));
+        }
+
+        const Record* find(int id) const {
+            if (slots.empty()) {
+                return nullptr;
+            }
+            size_t mask = slots.size() - 1;
+            for (size_t i = home(id, mask);; i = (i + 1) & mask) {
+                if (slots[i].status == StatusTable::NONE) return nullptr;
+                if (slots[i].id == id) return &slots[i];
+            }
+        }
+
+        void insert(int id, uint16_t status) {
+            if ((count + 1) * 10 > slots.size() * 7) {
+                grow();
+            }
+            Record& record = place(id, status);
+            count++;
+            index(record);
+        }
+
+        Record& place(int id, uint16_t status) {
+            size_t mask = slots.size() - 1;
+            size_t i = home(id, mask);
+            while (slots[i].status != StatusTable::NONE) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = { id, status, 0 };
+            return slots[i];
+        }
+
+        void grow() {
+            std::vector<Record> old(std::max<size_t>(16, slots.size() * 2), Record{ 0, StatusTable::NONE, 0 });
+            old.swap(slots);
+            for (const Record& record : old) {
+                if (record.status != StatusTable::NONE) {
+                    place(record.id, record.status).position = record.position;
+                }
+            }
+        }
+
+        // Backward-shift deletion keeps probe chains intact without tombstones
+        void erase(Record* record) {
+            size_t mask = slots.size() - 1;
+            size_t hole = static_cast<size_t>(record - slots.data());
+            for (size_t i = (hole + 1) & mask; slots[i].status != StatusTable::NONE; i = (i + 1) & mask) {
+                size_t want = home(slots[i].id, mask);
+                // Move the record back if its home is not in (hole, i]
+                if (((i - want) & mask) >= ((i - hole) & mask)) {
+                    slots[hole] = slots[i];
+                    hole = i;
+                }
+            }
+            slots[hole].status = StatusTable::NONE;
+            count--;
+        }
+
+        void index(Record& record) {
+            if (record.status >= byStatus.size()) {
+                byStatus.resize(record.status + 1);
+            }
+            std::vector<int>& ids = byStatus[record.status];
+            record.position = static_cast<uint32_t>(ids.size());
+            ids.push_back(record.id);
+        }
+
+        // Swap-removes the id from its status list
+        void unindex(const Record& record) {
+            std::vector<int>& ids = byStatus[record.status];
+            int last = ids.back();
+            ids[record.position] = last;
+            ids.pop_back();
+            if (last != record.id) {
+                find(last)->position = record.position;
+            }
+        }
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    size_t shardMask;
+    StatusTable statuses;
+    SubscriberRegistry<Observer> everyOrder;
+
+    Shard& shardOf(int id) {
+        return shards[static_cast<uint32_t>(id) * 0x9E3779B1u >> 16 & shardMask];
+    }
+
+    const Shard& shardOf(int id) const {
+        return shards[static_cast<uint32_t>(id) * 0x9E3779B1u >> 16 & shardMask];
+    }
+};
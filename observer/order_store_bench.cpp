@@ -0,0 +1,94 @@
+/**
+ * OrderStore at scale: loads millions of orders, then moves random orders
+ * through their statuses from several threads at once and queries the
+ * status index. One order in a hundred has its own observer.
+ *
+ * Usage: order_store_bench [orders] [seconds per run] [max threads]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "order_store.h"
+using namespace std;
+
+const string STATUSES[] = { "Order Placed", "Preparing", "Out for Delivery", "Delivered" };
+
+class CountingObserver : public Observer {
+public:
+    void update(Order*) override {}
+
+    void statusChanged(int, const string&) override {
+        received.fetch_add(1, memory_order_relaxed);
+    }
+
+    atomic<uint64_t> received{ 0 };
+};
+
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int orders = (argc > 1) ? atoi(argv[1]) : 2000000;
+    double seconds = (argc > 2) ? atof(argv[2]) : 1.0;
+    int maxThreads = (argc > 3) ? atoi(argv[3]) : 8;
+
+    OrderStore store;
+    auto start = chrono::steady_clock::now();
+    for (int id = 0; id < orders; id++) {
+        store.add(id, STATUSES[0]);
+    }
+    double loadSeconds = secondsSince(start);
+    vector<CountingObserver> watchers(orders / 100 + 1);
+    for (int id = 0; id < orders; id += 100) {
+        store.attach(id, &watchers[id / 100]);
+    }
+
+    cout << fixed << setprecision(1);
+    cout << orders << " orders loaded in " << loadSeconds << "s, "
+         << static_cast<double>(store.memoryUsage()) / orders << " bytes per order in the store "
+         << "(an Order object alone is " << sizeof(Order) << " bytes before its subscriber list)\n";
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        atomic<bool> stop{ false };
+        atomic<uint64_t> updates{ 0 };
+        vector<thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                uint64_t seed = 0x9E3779B97F4A7C15ULL * (t + 1), count = 0;
+                while (!stop.load(memory_order_relaxed)) {
+                    seed ^= seed << 13;
+                    seed ^= seed >> 7;
+                    seed ^= seed << 17;
+                    store.setStatus(static_cast<int>(seed % orders), STATUSES[(seed >> 40) % 4]);
+                    count++;
+                }
+                updates += count;
+            });
+        }
+        this_thread::sleep_for(chrono::duration<double>(seconds));
+        stop = true;
+        for (thread& w : workers) {
+            w.join();
+        }
+        cout << "  " << threads << " thread(s): " << setprecision(2) << updates / seconds / 1e6
+             << " M status updates/s\n" << setprecision(1);
+    }
+
+    start = chrono::steady_clock::now();
+    size_t counted = store.countWithStatus("Out for Delivery");
+    double countMs = secondsSince(start) * 1e3;
+    start = chrono::steady_clock::now();
+    vector<int> ids = store.ordersWithStatus("Out for Delivery");
+    double listMs = secondsSince(start) * 1e3;
+    cout << "  " << counted << " orders out for delivery: counted in " << setprecision(3) << countMs
+         << " ms, listed in " << listMs << " ms\n";
+    return ids.size() == counted ? 0 : 1;
+}
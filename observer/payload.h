@@ -0,0 +1,72 @@
+/**
+ * Immutable, reference-counted message text.
+ *
+ * A Payload is built once per message; copying it bumps a count instead of
+ * copying the text, so a message can sit in a queue, reach any number of
+ * observers and be kept by some of them while the text exists only once.
+ * The text never changes after construction, so any thread may read it.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+class Payload {
+public:
+    Payload() = default;
+
+    explicit Payload(std::string text) : block(new Block{ { 1 }, std::move(text) }) {}
+
+    Payload(const Payload& other) : block(other.block) {
+        if (block != nullptr) {
+            block->references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    Payload(Payload&& other) noexcept : block(other.block) {
+        other.block = nullptr;
+    }
+
+    Payload& operator=(Payload other) noexcept {
+        std::swap(block, other.block);
+        return *this;
+    }
+
+    ~Payload() {
+        if (block != nullptr && block->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete block;
+        }
+    }
+
+    // Empty for a default-constructed payload
+    const std::string& str() const {
+        static const std::string empty;
+        return block != nullptr ? block->text : empty;
+    }
+
+    std::string_view view() const {
+        return str();
+    }
+
+    size_t size() const {
+        return str().size();
+    }
+
+    // Payloads and observers keeping this text
+    uint32_t useCount() const {
+        return block != nullptr ? block->references.load(std::memory_order_relaxed) : 0;
+    }
+
+private:
+    struct Block {
+        std::atomic<uint32_t> references;
+        const std::string text;
+    };
+
+    Block* block = nullptr;
+};
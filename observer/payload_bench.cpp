@@ -0,0 +1,170 @@
+/**
+ * Heap allocations per publish, text messages against shared Payloads, for
+ * 1, 10 and 1000 subscribers.
+ *
+ * Synchronous rows use observers that keep every message they get (as one
+ * that forwards messages to its own worker would); asynchronous rows use
+ * observers that only read them. Messages are built before timing starts,
+ * so only the publish path is counted.
+ *
+ * Usage: payload_bench [messages]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "publisher.h"
+using namespace std;
+
+static atomic<uint64_t> allocations{ 0 };
+
+// Counts every allocation. Out of line, so GCC does not match the malloc
+// and free inside against new and delete expressions and warn.
+#ifdef __GNUC__
+#define OUT_OF_LINE __attribute__((noinline))
+#else
+#define OUT_OF_LINE
+#endif
+
+OUT_OF_LINE void* operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) {
+        return p;
+    }
+    throw bad_alloc();
+}
+
+OUT_OF_LINE void operator delete(void* p) noexcept {
+    free(p);
+}
+
+OUT_OF_LINE void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+// Keeps the last 64 messages as strings
+class CopyingObserver : public Observer {
+public:
+    CopyingObserver() {
+        kept.reserve(64);
+    }
+
+    void update(const string& message) override {
+        if (kept.size() == 64) kept.clear();
+        kept.push_back(message);
+    }
+
+private:
+    vector<string> kept;
+};
+
+// Keeps the last 64 messages as shared payloads
+class SharingObserver : public Observer {
+public:
+    SharingObserver() {
+        kept.reserve(64);
+    }
+
+    void update(const string&) override {}
+
+    void receive(const Payload& payload) override {
+        if (kept.size() == 64) kept.clear();
+        kept.push_back(payload);
+    }
+
+private:
+    vector<Payload> kept;
+};
+
+class ReadingObserver : public Observer {
+public:
+    atomic<uint64_t> bytes{ 0 };
+
+    void update(const string& message) override {
+        bytes.fetch_add(message.size(), memory_order_relaxed);
+    }
+};
+
+struct Result {
+    double allocationsPerPublish;
+    double nsPerPublish;
+};
+
+template <typename Publish>
+static Result measure(int messages, Publish publish) {
+    uint64_t before = allocations.load();
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < messages; i++) {
+        publish(i);
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return { double(allocations.load() - before) / messages, seconds * 1e9 / messages };
+}
+
+template <typename Subscriber, typename Message>
+static Result synchronous(int subscribers, int messages, const vector<Message>& texts) {
+    vector<Subscriber> observers(subscribers);
+    Publisher publisher;
+    for (Subscriber& o : observers) {
+        publisher.subscribe(&o);
+    }
+    return measure(messages, [&](int i) {
+        publisher.notify(texts[i % texts.size()]);
+    });
+}
+
+template <typename Message>
+static Result asynchronous(int subscribers, int messages, const vector<Message>& texts) {
+    vector<ReadingObserver> observers(subscribers);
+    AsyncPublisher publisher(1024);
+    for (ReadingObserver& o : observers) {
+        publisher.subscribe(&o);
+    }
+    Result result = measure(messages, [&](int i) {
+        publisher.notify(texts[i % texts.size()]);
+    });
+    publisher.flush();
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    int messages = (argc > 1) ? atoi(argv[1]) : 20000;
+    vector<string> texts;
+    vector<Payload> payloads;
+    for (int i = 0; i < 256; i++) {
+        texts.push_back("orders." + to_string(100000 + i) + ".out-for-delivery");
+        payloads.emplace_back(texts.back());
+    }
+
+    cout << "allocations per publish (ns per publish)\n" << fixed;
+    cout << "  subscribers                 " << setw(16) << 1 << setw(16) << 10 << setw(16) << 1000 << "\n";
+    auto row = [&](const char* label, Result (*run)(int, int, const void*), const void* input) {
+        cout << "  " << left << setw(28) << label << right;
+        for (int subscribers : { 1, 10, 1000 }) {
+            int count = subscribers == 1000 ? messages / 10 : messages;
+            Result r = run(subscribers, count, input);
+            cout << setprecision(2) << setw(8) << r.allocationsPerPublish << " (" << setprecision(0) << setw(5)
+                 << r.nsPerPublish << ")";
+        }
+        cout << "\n";
+    };
+    row("sync, observers copy", [](int s, int m, const void* in) {
+        return synchronous<CopyingObserver>(s, m, *static_cast<const vector<string>*>(in));
+    }, &texts);
+    row("sync, observers share", [](int s, int m, const void* in) {
+        return synchronous<SharingObserver>(s, m, *static_cast<const vector<Payload>*>(in));
+    }, &payloads);
+    row("async, string", [](int s, int m, const void* in) {
+        return asynchronous(s, m, *static_cast<const vector<string>*>(in));
+    }, &texts);
+    row("async, payload", [](int s, int m, const void* in) {
+        return asynchronous(s, m, *static_cast<const vector<Payload>*>(in));
+    }, &payloads);
+    return 0;
+}
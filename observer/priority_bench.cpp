@@ -0,0 +1,130 @@
+/**
+ * Delivery latency under load: every order has a customer, a restaurant, a
+ * driver and the call center, each taking the same time per notification.
+ * Status changes arrive at a fixed rate with a burst above capacity in the
+ * middle of the run. First every observer shares one class (plain FIFO),
+ * then drivers are CRITICAL, customers HIGH, restaurants NORMAL and the
+ * call center LOW.
+ *
+ * Usage: priority_bench [changes/s] [seconds] [workers] [us per call]
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "priority_dispatcher.h"
+using namespace std;
+
+const char* STATUSES[] = { "Order Placed", "Preparing", "Out for Delivery", "Delivered" };
+
+// Busy for a fixed time per notification, like an observer doing real work
+class WorkObserver : public StatusObserver {
+public:
+    explicit WorkObserver(chrono::microseconds cost) : cost(cost) {}
+
+    void statusChanged(int, const string&) override {
+        auto until = chrono::steady_clock::now() + cost;
+        while (chrono::steady_clock::now() < until) {
+        }
+    }
+
+private:
+    chrono::microseconds cost;
+};
+
+struct Kind {
+    const char* name;
+    Priority priority;
+    chrono::microseconds deadline;
+};
+
+const Kind KINDS[] = {
+    { "driver", Priority::CRITICAL, chrono::milliseconds(5) },
+    { "customer", Priority::HIGH, chrono::milliseconds(50) },
+    { "restaurant", Priority::NORMAL, chrono::milliseconds(200) },
+    { "call center", Priority::LOW, chrono::milliseconds(1000) },
+};
+
+static void header(const char* title) {
+    cout << left << setw(26) << title << right << setw(8) << "calls" << setw(10) << "p50 ms" << setw(10) << "p99 ms"
+         << setw(10) << "p99.9 ms" << setw(10) << "max ms" << setw(8) << "missed" << "\n";
+}
+
+static void report(const char* label, const PriorityDispatcher& d, Priority p) {
+    const LatencyHistogram& h = d.latency(p);
+    cout << "  " << left << setw(24) << label << right << setw(8) << h.count() << fixed << setprecision(2)
+         << setw(10) << h.percentile(50) / 1e6 << setw(10) << h.percentile(99) / 1e6 << setw(10)
+         << h.percentile(99.9) / 1e6 << setw(10) << h.max() / 1e6 << setw(8) << d.missed(p) << "\n";
+}
+
+// Drives status changes at `rate` per second, doubled for the middle fifth
+static void run(bool prioritized, int rate, double seconds, int workers, chrono::microseconds cost) {
+    PriorityDispatcher dispatcher(workers);
+    vector<unique_ptr<WorkObserver>> observers;
+    auto make = [&](int kind) {
+        observers.emplace_back(new WorkObserver(cost));
+        const Kind& k = KINDS[kind];
+        return dispatcher.route(observers.back().get(), prioritized ? k.priority : Priority::NORMAL,
+                                prioritized ? k.deadline : chrono::microseconds(chrono::milliseconds(5)));
+    };
+    vector<Observer*> restaurants, drivers;
+    for (int i = 0; i < 10; i++) restaurants.push_back(make(2));
+    for (int i = 0; i < 50; i++) drivers.push_back(make(0));
+    Observer* callCenter = make(3);
+    vector<unique_ptr<Order>> orders;
+    for (int i = 0; i < 1000; i++) {
+        orders.emplace_back(new Order(i));
+        orders.back()->attach(make(1));
+        orders.back()->attach(restaurants[i % restaurants.size()]);
+        orders.back()->attach(drivers[i % drivers.size()]);
+        orders.back()->attach(callCenter);
+    }
+
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    auto start = chrono::steady_clock::now();
+    auto next = start;
+    auto end = start + chrono::duration<double>(seconds);
+    auto burstStart = start + chrono::duration<double>(seconds * 0.4);
+    auto burstEnd = start + chrono::duration<double>(seconds * 0.6);
+    while (next < end) {
+        this_thread::sleep_until(next);
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        orders[seed % orders.size()]->setStatus(STATUSES[(seed >> 32) % 4]);
+        bool burst = next >= burstStart && next < burstEnd;
+        chrono::duration<double> gap(1.0 / (burst ? 2 * rate : rate));
+        next += chrono::duration_cast<chrono::steady_clock::duration>(gap);
+    }
+    dispatcher.flush();
+
+    if (prioritized) {
+        header("prioritized");
+        for (const Kind& k : KINDS) {
+            string label = string(k.name) + " (" + to_string(k.deadline.count() / 1000) + " ms)";
+            report(label.c_str(), dispatcher, k.priority);
+        }
+    } else {
+        header("FIFO, one class");
+        report("every observer (5 ms)", dispatcher, Priority::NORMAL);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int rate = (argc > 1) ? atoi(argv[1]) : 8000;
+    double seconds = (argc > 2) ? atof(argv[2]) : 2.0;
+    int workers = (argc > 3) ? atoi(argv[3]) : 2;
+    chrono::microseconds cost((argc > 4) ? atoi(argv[4]) : 20);
+
+    cout << rate << " changes/s (" << 2 * rate << "/s in the burst), 4 observers each, " << workers
+         << " workers, " << cost.count() << " us per call\n";
+    run(false, rate, seconds, workers, cost);
+    run(true, rate, seconds, workers, cost);
+    return 0;
+}
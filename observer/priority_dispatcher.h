@@ -0,0 +1,277 @@
+/**
+ * Priority and deadline-aware delivery of order notifications.
+ *
+ * Each observer is routed through the dispatcher with a priority class and
+ * a deadline: route() returns a stand-in observer to attach to orders (or
+ * to subscribe to an OrderStore) in its place. Notifications wait in one
+ * queue per class; a pool of workers always serves the highest non-empty
+ * class, and within a class the earliest deadline first. Under a backlog,
+ * a DeliveryDriver routed as CRITICAL is served ahead of a CallCenter
+ * routed as LOW, and lower classes wait for as long as higher ones stay
+ * busy.
+ *
+ * Routed observers are StatusObservers, called through statusChanged with
+ * the status the order had when it changed. A status from an Order or an
+ * OrderStore travels as a code in its own table; any other caller's status
+ * is copied. With more than one worker an observer may be called from
+ * several threads at once and see changes out of order.
+ *
+ * Every class keeps a latency histogram (change to end of the observer
+ * call) and a count of deliveries that finished past their deadline.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "order.h"
+
+enum class Priority { CRITICAL, HIGH, NORMAL, LOW };
+
+const int PRIORITY_CLASSES = 4;
+
+// Log-linear buckets, 8 per power of two: values are kept to within 12.5%.
+// Any thread may record while others read.
+class LatencyHistogram {
+public:
+    static const int BUCKETS = 8 * 62;
+
+    void record(uint64_t nanoseconds) {
+        buckets[bucketOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        uint64_t high = largest.load(std::memory_order_relaxed);
+        while (nanoseconds > high && !largest.compare_exchange_weak(high, nanoseconds, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const {
+        return total.load(std::memory_order_relaxed);
+    }
+
+    uint64_t max() const {
+        return largest.load(std::memory_order_relaxed);
+    }
+
+    // Upper bound of the bucket holding the p-th percentile (0 < p <= 100)
+    uint64_t percentile(double p) const {
+        uint64_t n = count();
+        if (n == 0) {
+            return 0;
+        }
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(p / 100.0 * n + 0.5));
+        uint64_t seen = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            seen += buckets[b].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                return std::min(upperBound(b), max());
+            }
+        }
+        return max();
+    }
+
+    void reset() {
+        for (auto& bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        total.store(0, std::memory_order_relaxed);
+        largest.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> buckets[BUCKETS] = {};
+    std::atomic<uint64_t> total{ 0 }, largest{ 0 };
+
+    static int bucketOf(uint64_t value) {
+        if (value < 8) {
+            return static_cast<int>(value);
+        }
+        int exponent = 63 - __builtin_clzll(value);
+        return std::min(BUCKETS - 1, (exponent - 2) * 8 + static_cast<int>((value >> (exponent - 3)) & 7));
+    }
+
+    static uint64_t upperBound(int bucket) {
+        if (bucket < 8) {
+            return static_cast<uint64_t>(bucket);
+        }
+        int exponent = bucket / 8 + 2;
+        uint64_t step = 1ULL << (exponent - 3);
+        return (8 + static_cast<uint64_t>(bucket % 8)) * step + step - 1;
+    }
+};
+
+class PriorityDispatcher {
+public:
+    explicit PriorityDispatcher(int workers = 2) {
+        for (int i = 0; i < std::max(1, workers); i++) {
+            threads.emplace_back([this] { work(); });
+        }
+    }
+
+    // Delivers everything still queued, then stops the workers
+    ~PriorityDispatcher() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        taskReady.notify_all();
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    }
+
+    PriorityDispatcher(const PriorityDispatcher&) = delete;
+    PriorityDispatcher& operator=(const PriorityDispatcher&) = delete;
+
+    // The observer to attach in place of `target`; owned by the dispatcher
+    Observer* route(StatusObserver* target, Priority priority, std::chrono::microseconds deadline) {
+        std::lock_guard<std::mutex> lock(mutex);
+        routes.emplace_back(new Route(*this, target, priority, deadline));
+        return routes.back().get();
+    }
+
+    // Waits until every queued notification has been delivered
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex);
+        drained.wait(lock, [this] { return queued == 0 && running == 0; });
+    }
+
+    size_t backlog() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return queued;
+    }
+
+    const LatencyHistogram& latency(Priority priority) const {
+        return classes[static_cast<int>(priority)].latency;
+    }
+
+    // Deliveries that finished after their deadline
+    uint64_t missed(Priority priority) const {
+        return classes[static_cast<int>(priority)].missed.load(std::memory_order_relaxed);
+    }
+
+    void resetStats() {
+        for (Class& c : classes) {
+            c.latency.reset();
+            c.missed.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    class Route : public Observer {
+    public:
+        Route(PriorityDispatcher& dispatcher, StatusObserver* target, Priority priority,
+              std::chrono::microseconds deadline)
+            : dispatcher(dispatcher), target(target), priority(priority), deadline(deadline) {}
+
+        void update(Order* order) override {
+            dispatcher.enqueue(*this, order->getId(), &orderStatuses(), order->getStatusCode(), std::string());
+        }
+
+        void statusCodeChanged(int orderId, uint16_t status, const StatusTable& table) override {
+            dispatcher.enqueue(*this, orderId, &table, status, std::string());
+        }
+
+        void statusChanged(int orderId, const std::string& status) override {
+            dispatcher.enqueue(*this, orderId, nullptr, StatusTable::NONE, status);
+        }
+
+        PriorityDispatcher& dispatcher;
+        StatusObserver* target;
+        Priority priority;
+        Clock::duration deadline;
+    };
+
+    struct Task {
+        Clock::time_point changed;
+        Clock::time_point due;
+        uint64_t sequence; // Breaks deadline ties in arrival order
+        Route* route;
+        int orderId;
+        const StatusTable* table; // Null when the status came as text
+        uint16_t status;
+        std::string text;
+
+        const std::string& name() const {
+            return table != nullptr ? table->name(status) : text;
+        }
+    };
+
+    // Earliest deadline at the front of each class's heap
+    static bool later(const Task& a, const Task& b) {
+        return a.due != b.due ? a.due > b.due : a.sequence > b.sequence;
+    }
+
+    struct Class {
+        std::vector<Task> heap;
+        LatencyHistogram latency;
+        std::atomic<uint64_t> missed{ 0 };
+    };
+
+    mutable std::mutex mutex;
+    std::condition_variable taskReady, drained;
+    Class classes[PRIORITY_CLASSES];
+    std::vector<std::unique_ptr<Route>> routes;
+    std::vector<std::thread> threads;
+    size_t queued = 0;
+    int running = 0;
+    uint64_t arrivals = 0;
+    bool stopping = false;
+
+    void enqueue(Route& route, int orderId, const StatusTable* table, uint16_t status, std::string text) {
+        Clock::time_point now = Clock::now();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::vector<Task>& heap = classes[static_cast<int>(route.priority)].heap;
+            heap.push_back({ now, now + route.deadline, arrivals++, &route, orderId, table, status, std::move(text) });
+            std::push_heap(heap.begin(), heap.end(), later);
+            queued++;
+        }
+        taskReady.notify_one();
+    }
+
+    void work() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            taskReady.wait(lock, [this] { return queued > 0 || stopping; });
+            if (queued == 0) {
+                return;
+            }
+            Class* from = classes;
+            while (from->heap.empty()) {
+                from++;
+            }
+            std::pop_heap(from->heap.begin(), from->heap.end(), later);
+            Task task = std::move(from->heap.back());
+            from->heap.pop_back();
+            queued--;
+            running++;
+            lock.unlock();
+
+            task.route->target->statusChanged(task.orderId, task.name());
+            Clock::time_point done = Clock::now();
+            from->latency.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(done - task.changed).count()));
+            if (done > task.due) {
+                from->missed.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            lock.lock();
+            running--;
+            if (queued == 0 && running == 0) {
+                drained.notify_all();
+            }
+        }
+    }
+};
@@ -0,0 +1,231 @@
+/**
+ * Publishers for the observer example.
+ *
+ * Both keep their observers in a SubscriberRegistry, so observers can come
+ * and go from any thread while messages are being delivered.
+ *
+ * Publisher calls every observer on the publishing thread. AsyncPublisher
+ * instead pushes each message into a bounded lock-free queue and returns;
+ * dispatcher threads pop messages and fan them out, so a slow observer
+ * delays delivery but not the producer. What happens when the queue is full
+ * is up to the Backpressure policy.
+ *
+ * Messages can also travel as Payloads: observers then share one copy of
+ * the text, and AsyncPublisher queues a pointer instead of a string.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bounded_queue.h"
+#include "payload.h"
+#include "subscriber_registry.h"
+
+// Observer (Subscriber) interface
+class Observer {
+public:
+    virtual ~Observer() = default;
+
+    // Pure virtual function to update the observer with a message
+    virtual void update(const std::string& message) = 0;
+
+    // A shared message; override to keep it past the call without copying
+    virtual void receive(const Payload& payload) {
+        update(payload.str());
+    }
+};
+
+// Subject (Publisher) class
+class Publisher {
+private:
+    // List of observers
+    SubscriberRegistry<Observer> observers;
+
+public:
+    // Attach an observer to the publisher
+    void subscribe(Observer* observer) {
+        observers.add(observer);
+    }
+
+    // Detach an observer from the publisher
+    void unsubscribe(Observer* observer) {
+        observers.remove(observer);
+    }
+
+    void notify(const std::string& message) {
+        // Notify all observers with the message
+        observers.forEach([&](Observer* observer) {
+            observer->update(message);
+        });
+    }
+
+    void notify(const Payload& payload) {
+        observers.forEach([&](Observer* observer) {
+            observer->receive(payload);
+        });
+    }
+};
+
+// What notify does when the queue is full
+enum class Backpressure {
+    BLOCK,       // Wait for a dispatcher to make room
+    DROP_OLDEST, // Discard the oldest queued message to make room
+    DROP_NEWEST  // Discard the message being published
+};
+
+struct QueueMetrics {
+    size_t depth;        // Messages waiting now
+    size_t capacity;
+    size_t highWater;    // Deepest the queue has been
+    uint64_t published;  // notify calls
+    uint64_t delivered;  // Messages fanned out to every observer
+    uint64_t dropped;    // Messages discarded by the backpressure policy
+};
+
+// Sleeps threads until another thread reports progress. Waking is a load
+// and a branch when nobody is waiting, so the lock-free paths stay cheap.
+class WaitPoint {
+public:
+    template <typename Ready>
+    void wait(Ready ready) {
+        waiters.fetch_add(1);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, ready);
+        }
+        waiters.fetch_sub(1);
+    }
+
+    void wake() {
+        // Orders the caller's queue update before the waiter check
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            condition.notify_all();
+        }
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::atomic<int> waiters{ 0 };
+};
+
+class AsyncPublisher {
+public:
+    // With more than one dispatcher, an observer may see messages out of order
+    explicit AsyncPublisher(size_t capacity, Backpressure policy = Backpressure::BLOCK, int dispatchers = 1)
+        : queue(capacity), policy(policy) {
+        for (int i = 0; i < std::max(1, dispatchers); i++) {
+            threads.emplace_back([this] { dispatch(); });
+        }
+    }
+
+    // Delivers everything still queued, then stops the dispatchers
+    ~AsyncPublisher() {
+        stopping = true;
+        messageReady.wake();
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    }
+
+    AsyncPublisher(const AsyncPublisher&) = delete;
+    AsyncPublisher& operator=(const AsyncPublisher&) = delete;
+
+    void subscribe(Observer* observer) {
+        observers.add(observer);
+    }
+
+    // Waits for deliveries in progress, so the observer is never called
+    // once this returns
+    void unsubscribe(Observer* observer) {
+        observers.remove(observer);
+    }
+
+    // Queues the message for delivery. False if it was dropped (DROP_NEWEST).
+    bool notify(const std::string& message) {
+        return notify(Payload(message));
+    }
+
+    bool notify(std::string&& message) {
+        return notify(Payload(std::move(message)));
+    }
+
+    // Queues a shared payload; nothing is copied or allocated
+    bool notify(Payload pending) {
+        published.fetch_add(1, std::memory_order_relaxed);
+        while (!queue.tryPush(std::move(pending))) {
+            if (policy == Backpressure::DROP_NEWEST) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                drained.wake();
+                return false;
+            }
+            if (policy == Backpressure::DROP_OLDEST) {
+                Payload oldest;
+                if (queue.tryPop(oldest)) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+                continue;
+            }
+            spaceReady.wait([this] { return queue.size() < queue.capacity(); });
+        }
+        size_t depth = queue.size();
+        size_t high = highWater.load(std::memory_order_relaxed);
+        while (depth > high && !highWater.compare_exchange_weak(high, depth, std::memory_order_relaxed)) {
+        }
+        messageReady.wake();
+        return true;
+    }
+
+    // Waits until every message published so far is delivered or dropped
+    void flush() {
+        drained.wait([this] {
+            return delivered.load() + dropped.load() >= published.load();
+        });
+    }
+
+    QueueMetrics metrics() const {
+        return { queue.size(), queue.capacity(), highWater.load(), published.load(),
+                 delivered.load(), dropped.load() };
+    }
+
+private:
+    BoundedQueue<Payload> queue;
+    Backpressure policy;
+    SubscriberRegistry<Observer> observers;
+    std::vector<std::thread> threads;
+    std::atomic<bool> stopping{ false };
+    WaitPoint messageReady, spaceReady, drained;
+    std::atomic<size_t> highWater{ 0 };
+    std::atomic<uint64_t> published{ 0 }, delivered{ 0 }, dropped{ 0 };
+
+    void dispatch() {
+        Payload message;
+        while (true) {
+            if (queue.tryPop(message)) {
+                spaceReady.wake();
+                observers.forEach([&](Observer* observer) {
+                    observer->receive(message);
+                });
+                message = Payload();
+                delivered.fetch_add(1, std::memory_order_relaxed);
+                drained.wake();
+                continue;
+            }
+            if (stopping) {
+                return;
+            }
+            messageReady.wait([this] { return queue.size() > 0 || stopping; });
+        }
+    }
+};
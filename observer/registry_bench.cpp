@@ -0,0 +1,111 @@
+/**
+ * Notify throughput while subscriptions churn: SubscriberRegistry against a
+ * vector behind a reader-writer lock.
+ *
+ * Reader threads walk the list of 100 observers as fast as they can; a
+ * churn thread, when enabled, subscribes and unsubscribes one more observer
+ * in a loop. Each case runs for the given time.
+ *
+ * Usage: registry_bench [seconds per case] [reader threads]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+#include "subscriber_registry.h"
+using namespace std;
+
+struct Subscriber {
+    uint64_t id;
+};
+
+// The obvious thread-safe list, for comparison
+class LockedRegistry {
+public:
+    void add(Subscriber* s) {
+        unique_lock<shared_mutex> lock(mutex);
+        list.push_back(s);
+    }
+
+    void remove(Subscriber* s) {
+        unique_lock<shared_mutex> lock(mutex);
+        list.erase(find(list.begin(), list.end(), s));
+    }
+
+    template <typename Visit>
+    void forEach(Visit visit) {
+        shared_lock<shared_mutex> lock(mutex);
+        for (Subscriber* s : list) {
+            visit(s);
+        }
+    }
+
+private:
+    vector<Subscriber*> list;
+    shared_mutex mutex;
+};
+
+template <typename Registry>
+static void run(const char* name, bool churn, double seconds, int readers) {
+    Registry registry;
+    vector<Subscriber> subscribers(100);
+    for (size_t i = 0; i < subscribers.size(); i++) {
+        subscribers[i].id = i;
+        registry.add(&subscribers[i]);
+    }
+    Subscriber extra{ 1000 };
+
+    atomic<bool> stop{ false };
+    atomic<uint64_t> notifies{ 0 }, churnOps{ 0 }, checksum{ 0 };
+    vector<thread> threads;
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&] {
+            uint64_t count = 0, sum = 0;
+            while (!stop.load(memory_order_relaxed)) {
+                registry.forEach([&](Subscriber* s) { sum += s->id; });
+                count++;
+            }
+            notifies += count;
+            checksum += sum;
+        });
+    }
+    if (churn) {
+        threads.emplace_back([&] {
+            uint64_t count = 0;
+            while (!stop.load(memory_order_relaxed)) {
+                registry.add(&extra);
+                registry.remove(&extra);
+                count += 2;
+            }
+            churnOps += count;
+        });
+    }
+    this_thread::sleep_for(chrono::duration<double>(seconds));
+    stop = true;
+    for (thread& t : threads) {
+        t.join();
+    }
+
+    cout << "  " << left << setw(22) << name << (churn ? "churn   " : "steady  ") << right << fixed
+         << setprecision(2) << setw(8) << notifies / seconds / 1e6 << " M notifies/s  "
+         << setw(8) << setprecision(0) << churnOps / seconds << " (un)subscribes/s\n";
+}
+
+int main(int argc, char* argv[]) {
+    double seconds = (argc > 1) ? atof(argv[1]) : 1.0;
+    int readers = (argc > 2) ? atoi(argv[2]) : max(2u, thread::hardware_concurrency());
+
+    cout << readers << " reader threads, 100 observers\n";
+    run<LockedRegistry>("shared_mutex vector", false, seconds, readers);
+    run<LockedRegistry>("shared_mutex vector", true, seconds, readers);
+    run<SubscriberRegistry<Subscriber>>("SubscriberRegistry", false, seconds, readers);
+    run<SubscriberRegistry<Subscriber>>("SubscriberRegistry", true, seconds, readers);
+    return 0;
+}
@@ -0,0 +1,99 @@
+/**
+ * Status strings interned to small integer codes, shared by everything that
+ * passes order statuses around: a status is stored and compared as a code,
+ * and its name is a reference that stays valid as long as the table.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "subscriber_registry.h"
+
+// Status strings interned to 16-bit codes. Lookups read an RCU snapshot of
+// the name map; names never move once added.
+class StatusTable {
+public:
+    static const uint16_t MAX_STATUSES = 1024;
+    static const uint16_t NONE = 0xFFFF;
+
+    StatusTable() : codes(new CodeMap()) {}
+
+    ~StatusTable() {
+        delete codes.load();
+        for (const CodeMap* map : retired) {
+            delete map;
+        }
+        for (auto& name : names) {
+            delete name.load();
+        }
+    }
+
+    StatusTable(const StatusTable&) = delete;
+    StatusTable& operator=(const StatusTable&) = delete;
+
+    // NONE if the status was never interned
+    uint16_t find(std::string_view status) const {
+        RcuReadSection section;
+        const CodeMap& map = *codes.load(std::memory_order_acquire);
+        auto it = map.find(status);
+        return it == map.end() ? NONE : it->second;
+    }
+
+    // NONE once MAX_STATUSES distinct statuses exist
+    uint16_t intern(std::string_view status) {
+        uint16_t code = find(status);
+        if (code != NONE) {
+            return code;
+        }
+        RcuDomain& rcu = RcuDomain::instance();
+        std::vector<const CodeMap*> reclaim;
+        {
+            std::lock_guard<std::mutex> lock(writeMutex);
+            const CodeMap* old = codes.load(std::memory_order_relaxed);
+            auto it = old->find(status);
+            if (it != old->end()) {
+                return it->second;
+            }
+            if (count == MAX_STATUSES) {
+                return NONE;
+            }
+            const std::string* name = new std::string(status);
+            names[count].store(name, std::memory_order_release);
+            CodeMap* next = new CodeMap(*old);
+            (*next)[*name] = count;
+            codes.store(next, std::memory_order_release);
+            retired.push_back(old);
+            code = count++;
+            if (rcu.inReadSection()) {
+                return code;
+            }
+            reclaim.swap(retired);
+        }
+        // Wait outside the lock: a reader may be about to intern too
+        rcu.synchronize();
+        for (const CodeMap* map : reclaim) {
+            delete map;
+        }
+        return code;
+    }
+
+    const std::string& name(uint16_t code) const {
+        return *names[code].load(std::memory_order_acquire);
+    }
+
+private:
+    using CodeMap = std::unordered_map<std::string_view, uint16_t>;
+
+    std::atomic<const CodeMap*> codes;
+    std::atomic<const std::string*> names[MAX_STATUSES] = {};
+    uint16_t count = 0;
+    std::mutex writeMutex;
+    std::vector<const CodeMap*> retired; // Replaced maps waiting for a grace period
+};
@@ -0,0 +1,191 @@
+/**
+ * Thread-safe subscriber lists for publishers and subjects.
+ *
+ * Readers (notify) walk an immutable snapshot of the list without locks:
+ * entering a read section is one increment on a per-thread-stripe counter.
+ * Writers (subscribe, unsubscribe) copy the list, publish the copy with one
+ * atomic store and wait for a grace period, i.e. until every read section
+ * that might still see the old snapshot has finished, before freeing it.
+ * Churn therefore costs the writers, never the readers.
+ *
+ * The grace period also means an observer is not called any more once
+ * unsubscribe has returned. A write made from inside a read section (an
+ * observer unsubscribing itself from update) cannot wait for its own
+ * section; it skips the wait and the old snapshot is freed by a later write.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Read sections and grace periods shared by every registry, as in RCU
+class RcuDomain {
+public:
+    static RcuDomain& instance() {
+        static RcuDomain domain;
+        return domain;
+    }
+
+    // Enters a read section; returns the epoch to hand back to exit()
+    unsigned enter() {
+        Stripe& stripe = stripes[stripeIndex()];
+        depth()++;
+        while (true) {
+            unsigned epoch = currentEpoch.load() & 1;
+            stripe.readers[epoch].fetch_add(1);
+            if ((currentEpoch.load() & 1) == epoch) {
+                return epoch;
+            }
+            stripe.readers[epoch].fetch_sub(1, std::memory_order_release); // A writer flipped meanwhile
+        }
+    }
+
+    void exit(unsigned epoch) {
+        stripes[stripeIndex()].readers[epoch].fetch_sub(1, std::memory_order_release);
+        depth()--;
+    }
+
+    // Whether this thread is inside a read section of any registry
+    bool inReadSection() {
+        return depth() > 0;
+    }
+
+    // Returns once every read section entered before the call has exited.
+    // Sections entered afterwards count against the other epoch.
+    void synchronize() {
+        std::lock_guard<std::mutex> lock(graceMutex);
+        unsigned old = currentEpoch.fetch_add(1) & 1;
+        for (Stripe& stripe : stripes) {
+            while (stripe.readers[old].load(std::memory_order_acquire) != 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    static const int STRIPES = 16;
+
+    struct alignas(64) Stripe {
+        std::atomic<long> readers[2] = { {0}, {0} };
+    };
+
+    Stripe stripes[STRIPES];
+    std::atomic<unsigned> currentEpoch{ 0 };
+    std::mutex graceMutex;
+
+    RcuDomain() = default;
+
+    static int stripeIndex() {
+        static std::atomic<int> nextStripe{ 0 };
+        static thread_local int index = nextStripe.fetch_add(1, std::memory_order_relaxed) % STRIPES;
+        return index;
+    }
+
+    static int& depth() {
+        static thread_local int nesting = 0;
+        return nesting;
+    }
+};
+
+// Scoped read section, so a throwing observer cannot leave one open
+class RcuReadSection {
+public:
+    RcuReadSection() : epoch(RcuDomain::instance().enter()) {}
+
+    ~RcuReadSection() {
+        RcuDomain::instance().exit(epoch);
+    }
+
+    RcuReadSection(const RcuReadSection&) = delete;
+    RcuReadSection& operator=(const RcuReadSection&) = delete;
+
+private:
+    unsigned epoch;
+};
+
+template <typename T>
+class SubscriberRegistry {
+public:
+    using List = std::vector<T*>;
+
+    SubscriberRegistry() : current(new List()) {}
+
+    // No reader may still be inside forEach
+    ~SubscriberRegistry() {
+        delete current.load();
+        for (const List* list : retired) {
+            delete list;
+        }
+    }
+
+    SubscriberRegistry(const SubscriberRegistry&) = delete;
+    SubscriberRegistry& operator=(const SubscriberRegistry&) = delete;
+
+    void add(T* subscriber) {
+        update([subscriber](List& list) {
+            list.push_back(subscriber);
+            return true;
+        });
+    }
+
+    // Removes the first occurrence; false if it was not subscribed
+    bool remove(T* subscriber) {
+        return update([subscriber](List& list) {
+            auto it = std::find(list.begin(), list.end(), subscriber);
+            if (it == list.end()) {
+                return false;
+            }
+            list.erase(it);
+            return true;
+        });
+    }
+
+    // Calls visit(subscriber) for every subscriber in one consistent snapshot
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        RcuReadSection section;
+        for (T* subscriber : *current.load(std::memory_order_acquire)) {
+            visit(subscriber);
+        }
+    }
+
+    size_t size() const {
+        RcuReadSection section;
+        return current.load(std::memory_order_acquire)->size();
+    }
+
+private:
+    std::atomic<const List*> current;
+    std::mutex writeMutex;          // Serializes writers only
+    std::vector<const List*> retired; // Replaced snapshots waiting for a grace period
+
+    template <typename Edit>
+    bool update(Edit edit) {
+        RcuDomain& rcu = RcuDomain::instance();
+        std::vector<const List*> reclaim;
+        {
+            std::lock_guard<std::mutex> lock(writeMutex);
+            List* next = new List(*current.load(std::memory_order_relaxed));
+            if (!edit(*next)) {
+                delete next;
+                return false;
+            }
+            retired.push_back(current.exchange(next));
+            if (rcu.inReadSection()) {
+                return true;
+            }
+            reclaim.swap(retired);
+        }
+        // Wait outside the lock: a reader may be about to write too
+        rcu.synchronize();
+        for (const List* list : reclaim) {
+            delete list;
+        }
+        return true;
+    }
+};
@@ -0,0 +1,126 @@
+/**
+ * Selective delivery with many subscribers: TopicPublisher against a plain
+ * Publisher whose observers each filter every message on their own.
+ *
+ * Subscribers follow one order each (`orders.<id>.*`), except that every
+ * thousandth watches all deliveries (`orders.*.delivered`) and every ten
+ * thousandth everything (`orders.#`). Messages are `orders.<id>.<status>`
+ * for random orders and statuses, so each reaches a few dozen observers.
+ *
+ * Usage: topic_bench [subscribers] [messages]
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "topic_publisher.h"
+using namespace std;
+
+class Subscriber : public Observer {
+public:
+    string pattern;
+    uint64_t received = 0;
+
+    void update(const string&) override {
+        received++;
+    }
+};
+
+// Gets every message and keeps the ones matching its pattern
+class FilteringSubscriber : public Subscriber {
+public:
+    void update(const string& topic) override {
+        if (topicMatches(pattern, topic)) {
+            received++;
+        }
+    }
+};
+
+static string patternFor(int i) {
+    if (i % 1000 == 0) return "orders.*.delivered";
+    if (i % 10000 == 1) return "orders.#";
+    return "orders." + to_string(i) + ".*";
+}
+
+static uint64_t totalReceived(const vector<Subscriber*>& subscribers) {
+    uint64_t total = 0;
+    for (const Subscriber* s : subscribers) {
+        total += s->received;
+    }
+    return total;
+}
+
+static double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int subscriberCount = (argc > 1) ? atoi(argv[1]) : 100000;
+    int messageCount = (argc > 2) ? atoi(argv[2]) : 200000;
+    const char* statuses[] = { "placed", "preparing", "ready", "delivered" };
+
+    vector<string> topics;
+    uint64_t seed = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < messageCount; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        topics.push_back("orders." + to_string(seed % subscriberCount) + "." + statuses[(seed >> 32) % 4]);
+    }
+
+    // The flat publisher calls every observer per message, so it gets fewer
+    int flatMessages = min(messageCount, max(1, 20000000 / subscriberCount));
+    vector<FilteringSubscriber> filtering(subscriberCount);
+    vector<Subscriber*> flatList;
+    Publisher flat;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < subscriberCount; i++) {
+        filtering[i].pattern = patternFor(i);
+        flat.subscribe(&filtering[i]);
+        flatList.push_back(&filtering[i]);
+    }
+    double flatSubscribe = secondsSince(start);
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < flatMessages; i++) {
+        flat.notify(topics[i]);
+    }
+    double flatSeconds = secondsSince(start);
+    uint64_t flatDelivered = totalReceived(flatList);
+
+    vector<Subscriber> routed(subscriberCount);
+    vector<Subscriber*> routedList;
+    TopicPublisher router;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < subscriberCount; i++) {
+        router.subscribe(patternFor(i), &routed[i]);
+        routedList.push_back(&routed[i]);
+    }
+    double routedSubscribe = secondsSince(start);
+    for (int i = 0; i < flatMessages; i++) {
+        router.notify(topics[i], topics[i]);
+    }
+    bool same = totalReceived(routedList) == flatDelivered;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < messageCount; i++) {
+        router.notify(topics[i], topics[i]);
+    }
+    double routedSeconds = secondsSince(start);
+    uint64_t routedDelivered = totalReceived(routedList) - flatDelivered;
+
+    cout << subscriberCount << " subscribers\n" << fixed;
+    cout << "  Publisher + filtering  subscribe " << setprecision(3) << flatSubscribe << "s, "
+         << flatMessages << " messages, " << setprecision(1) << flatDelivered / double(flatMessages)
+         << " deliveries/message, " << setprecision(0) << flatMessages / flatSeconds << " messages/s, "
+         << setprecision(1) << flatSeconds * 1e6 / flatMessages << " us/message\n";
+    cout << "  TopicPublisher         subscribe " << setprecision(3) << routedSubscribe << "s, "
+         << messageCount << " messages, " << setprecision(1) << routedDelivered / double(messageCount)
+         << " deliveries/message, " << setprecision(0) << messageCount / routedSeconds << " messages/s, "
+         << setprecision(1) << routedSeconds * 1e6 / messageCount << " us/message\n";
+    cout << "  same deliveries on the first " << flatMessages << " messages: " << (same ? "yes" : "NO") << "\n";
+    cout << "  speedup " << setprecision(0) << (flatSeconds / flatMessages) / (routedSeconds / messageCount) << "x\n";
+    return same ? 0 : 1;
+}
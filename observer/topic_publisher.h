@@ -0,0 +1,304 @@
+/**
+ * Topic-based publisher: observers subscribe to dot-separated topic
+ * patterns and only hear about matching messages.
+ *
+ * In a pattern, `*` matches exactly one segment and a final `#` matches any
+ * number of remaining segments, including none: `orders.*.delivered`,
+ * `orders.42.#`. Patterns are stored in a trie with one node per segment,
+ * so a publish walks one path per wildcard branch and calls only the
+ * observers it reaches, whatever the total number of subscriptions.
+ *
+ * Publishing takes no locks, like SubscriberRegistry: nodes are never freed
+ * while the publisher lives, each node's observers are a SubscriberRegistry,
+ * and child tables only grow, with a replaced table freed after an RCU grace
+ * period. Subscribing takes one writer mutex.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "publisher.h"
+#include "subscriber_registry.h"
+
+// Splits a topic into at most `capacity` segments; 0 if empty or deeper
+inline size_t splitTopic(std::string_view topic, std::string_view* segments, size_t capacity) {
+    if (topic.empty()) {
+        return 0; // Not one empty segment, so "" is never a valid topic or pattern
+    }
+    size_t count = 0;
+    while (true) {
+        size_t dot = topic.find('.');
+        if (count == capacity) {
+            return 0;
+        }
+        segments[count++] = topic.substr(0, dot);
+        if (dot == std::string_view::npos) {
+            return count;
+        }
+        topic.remove_prefix(dot + 1);
+    }
+}
+
+// Whether a topic matches a pattern, without the trie
+inline bool topicMatches(std::string_view pattern, std::string_view topic) {
+    while (true) {
+        size_t patternDot = pattern.find('.');
+        std::string_view want = pattern.substr(0, patternDot);
+        if (want == "#" && patternDot == std::string_view::npos) {
+            return true;
+        }
+        size_t topicDot = topic.find('.');
+        if (want != "*" && want != topic.substr(0, topicDot)) {
+            return false;
+        }
+        if (patternDot == std::string_view::npos || topicDot == std::string_view::npos) {
+            return patternDot == topicDot || pattern.substr(patternDot + 1) == "#";
+        }
+        pattern.remove_prefix(patternDot + 1);
+        topic.remove_prefix(topicDot + 1);
+    }
+}
+
+class TopicPublisher {
+public:
+    static const size_t MAX_DEPTH = 16; // Segments per topic or pattern
+
+    TopicPublisher() : root(newNode("")) {}
+
+    // No notify may still be running
+    ~TopicPublisher() {
+        for (ChildTable::Table* table : retiredTables) {
+            delete table;
+        }
+    }
+
+    TopicPublisher(const TopicPublisher&) = delete;
+    TopicPublisher& operator=(const TopicPublisher&) = delete;
+
+    // False if the pattern is empty, too deep or has `#` before the end
+    bool subscribe(const std::string& pattern, Observer* observer) {
+        std::string_view segments[MAX_DEPTH];
+        size_t depth = splitTopic(pattern, segments, MAX_DEPTH);
+        for (size_t i = 0; i + 1 < depth; i++) {
+            if (segments[i] == "#") return false;
+        }
+        if (depth == 0) {
+            return false;
+        }
+        Node* node;
+        {
+            std::lock_guard<std::mutex> lock(writeMutex);
+            node = root;
+            for (size_t i = 0; i < depth; i++) {
+                node = child(node, segments[i]);
+            }
+        }
+        node->subscribers.add(observer);
+        reclaimTables();
+        return true;
+    }
+
+    // Removes one subscription made with exactly this pattern
+    bool unsubscribe(const std::string& pattern, Observer* observer) {
+        std::string_view segments[MAX_DEPTH];
+        size_t depth = splitTopic(pattern, segments, MAX_DEPTH);
+        Node* node = root;
+        {
+            RcuReadSection section;
+            for (size_t i = 0; i < depth && node != nullptr; i++) {
+                node = find(node, segments[i]);
+            }
+        }
+        return depth > 0 && node != nullptr && node->subscribers.remove(observer);
+    }
+
+    // Delivers the message to every observer whose pattern matches the
+    // topic, once per matching subscription. Returns how many were called.
+    size_t notify(const std::string& topic, const std::string& message) {
+        return route(topic, [&](Observer* observer) {
+            observer->update(message);
+        });
+    }
+
+    // The same, with every observer sharing one payload
+    size_t notify(const std::string& topic, const Payload& payload) {
+        return route(topic, [&](Observer* observer) {
+            observer->receive(payload);
+        });
+    }
+
+private:
+    struct Node;
+
+    template <typename Call>
+    size_t route(const std::string& topic, Call call) {
+        std::string_view segments[MAX_DEPTH];
+        size_t depth = splitTopic(topic, segments, MAX_DEPTH);
+        if (depth == 0) {
+            return 0;
+        }
+        size_t calls = 0;
+        auto visit = [&](Observer* observer) {
+            call(observer);
+            calls++;
+        };
+        RcuReadSection section;
+        deliver(root, segments, 0, depth, visit);
+        return calls;
+    }
+
+    // Insert-only open-addressing table of child nodes. Readers probe it
+    // without locks; a full table is replaced by one twice the size.
+    struct ChildTable {
+        struct Table {
+            size_t mask;
+            size_t count = 0;
+            std::unique_ptr<std::atomic<Node*>[]> slots;
+
+            explicit Table(size_t size) : mask(size - 1), slots(new std::atomic<Node*>[size]) {
+                for (size_t i = 0; i < size; i++) {
+                    slots[i].store(nullptr, std::memory_order_relaxed);
+                }
+            }
+        };
+
+        std::atomic<Table*> table{ nullptr };
+
+        ~ChildTable() {
+            delete table.load();
+        }
+
+        Node* find(std::string_view segment) const {
+            const Table* t = table.load(std::memory_order_acquire);
+            if (t == nullptr) {
+                return nullptr;
+            }
+            for (size_t i = std::hash<std::string_view>()(segment);; i++) {
+                Node* node = t->slots[i & t->mask].load(std::memory_order_acquire);
+                if (node == nullptr || node->segment == segment) {
+                    return node;
+                }
+            }
+        }
+
+        // Writer only; a replaced table goes to `retired`
+        void insert(Node* node, std::vector<Table*>& retired) {
+            Table* t = table.load(std::memory_order_relaxed);
+            if (t == nullptr || (t->count + 1) * 2 > t->mask + 1) {
+                Table* bigger = new Table(t == nullptr ? 4 : (t->mask + 1) * 2);
+                if (t != nullptr) {
+                    for (size_t i = 0; i <= t->mask; i++) {
+                        Node* existing = t->slots[i].load(std::memory_order_relaxed);
+                        if (existing != nullptr) place(*bigger, existing);
+                    }
+                    retired.push_back(t);
+                }
+                table.store(bigger, std::memory_order_release);
+                t = bigger;
+            }
+            place(*t, node);
+        }
+
+        static void place(Table& t, Node* node) {
+            size_t i = std::hash<std::string_view>()(node->segment);
+            while (t.slots[i & t.mask].load(std::memory_order_relaxed) != nullptr) {
+                i++;
+            }
+            t.slots[i & t.mask].store(node, std::memory_order_release);
+            t.count++;
+        }
+    };
+
+    struct Node {
+        std::string segment;
+        ChildTable children;                 // Exact segments
+        std::atomic<Node*> anyOne{ nullptr };  // `*`
+        std::atomic<Node*> anyRest{ nullptr }; // Final `#`
+        SubscriberRegistry<Observer> subscribers;
+    };
+
+    std::vector<std::unique_ptr<Node>> nodes; // Owns every node
+    Node* root;
+    std::mutex writeMutex;
+    std::vector<ChildTable::Table*> pendingTables, retiredTables;
+
+    Node* newNode(std::string_view segment) {
+        nodes.emplace_back(new Node());
+        nodes.back()->segment = std::string(segment);
+        return nodes.back().get();
+    }
+
+    static Node* find(const Node* node, std::string_view segment) {
+        if (segment == "*") return node->anyOne.load(std::memory_order_acquire);
+        if (segment == "#") return node->anyRest.load(std::memory_order_acquire);
+        return node->children.find(segment);
+    }
+
+    // Finds or creates a child; writer only
+    Node* child(Node* node, std::string_view segment) {
+        Node* existing = find(node, segment);
+        if (existing != nullptr) {
+            return existing;
+        }
+        Node* created = newNode(segment);
+        if (segment == "*") {
+            node->anyOne.store(created, std::memory_order_release);
+        } else if (segment == "#") {
+            node->anyRest.store(created, std::memory_order_release);
+        } else {
+            node->children.insert(created, pendingTables);
+        }
+        return created;
+    }
+
+    // Frees tables replaced by earlier subscriptions once no notify can
+    // still be probing them. A subscribe from inside update leaves them for
+    // a later one.
+    void reclaimTables() {
+        RcuDomain& rcu = RcuDomain::instance();
+        std::vector<ChildTable::Table*> reclaim;
+        {
+            std::lock_guard<std::mutex> lock(writeMutex);
+            if (pendingTables.empty()) {
+                return;
+            }
+            if (rcu.inReadSection()) {
+                retiredTables.insert(retiredTables.end(), pendingTables.begin(), pendingTables.end());
+                pendingTables.clear();
+                return;
+            }
+            reclaim.swap(pendingTables);
+            reclaim.insert(reclaim.end(), retiredTables.begin(), retiredTables.end());
+            retiredTables.clear();
+        }
+        rcu.synchronize();
+        for (ChildTable::Table* table : reclaim) {
+            delete table;
+        }
+    }
+
+    template <typename Visit>
+    static void deliver(const Node* node, const std::string_view* segments, size_t i, size_t depth, Visit& visit) {
+        if (const Node* rest = node->anyRest.load(std::memory_order_acquire)) {
+            rest->subscribers.forEach(visit);
+        }
+        if (i == depth) {
+            node->subscribers.forEach(visit);
+            return;
+        }
+        if (const Node* exact = node->children.find(segments[i])) {
+            deliver(exact, segments, i + 1, depth, visit);
+        }
+        if (const Node* one = node->anyOne.load(std::memory_order_acquire)) {
+            deliver(one, segments, i + 1, depth, visit);
+        }
+    }
+};
@@ -13,8 +13,28 @@
  * 2. Retrieve a student by their roll number.
  */
 
+/**
+ * Storage: every student is stored once, column by column. Roll numbers and
+ * names live in a string arena, marks in a float array and ranks in an int
+ * array, all indexed by row; the roll number and rank maps hold row numbers.
+ * A scan over marks reads nothing but marks.
+ *
+ * Rank queries can also return a StudentRange: a view over the rank map's
+ * row lists that reads each student from the table as it is visited,
+ * without copying. The rank map is ordered, so a range of ranks is a run of
+ * its entries.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 using namespace std;
@@ -33,34 +53,260 @@ public:
     Student(string r, string n, float m, int rk) : rollNo(r), name(n), marks(m), rank(rk) {}
 };
 
+// Strings packed into 64 KiB blocks that never move, so views into the
+// arena stay valid for as long as the arena does
+class StringArena {
+private:
+    static const size_t BLOCK_SIZE = 64 * 1024;
+    vector<unique_ptr<char[]>> blocks;
+    vector<unique_ptr<char[]>> large; // Strings over a quarter block, one each
+    size_t used = BLOCK_SIZE; // Bytes taken in blocks.back()
+    size_t largeBytes = 0;
+
+public:
+    string_view add(string_view text) {
+        if (text.empty()) {
+            return string_view(); // No block to point into before the first string
+        }
+        char* start;
+        if (text.size() > BLOCK_SIZE / 4) {
+            large.emplace_back(new char[text.size()]);
+            largeBytes += text.size();
+            start = large.back().get();
+        } else {
+            if (used + text.size() > BLOCK_SIZE) {
+                blocks.emplace_back(new char[BLOCK_SIZE]);
+                used = 0;
+            }
+            start = blocks.back().get() + used;
+            used += text.size();
+        }
+        text.copy(start, text.size());
+        return string_view(start, text.size());
+    }
+
+    size_t memoryUsage() const {
+        return (blocks.capacity() + large.capacity()) * sizeof(unique_ptr<char[]>) + blocks.size() * BLOCK_SIZE +
+               largeBytes;
+    }
+};
+
+// One read-only row of the table
+struct StudentView {
+    string_view rollNo;
+    string_view name;
+    float marks;
+    int rank;
+};
+
+// Students as columns: row i is rollNos[i], names[i], marks[i], ranks[i]
+class StudentTable {
+private:
+    StringArena text;
+    vector<string_view> rollNos;
+    vector<string_view> names;
+    vector<float> marks;
+    vector<int> ranks;
+
+public:
+    uint32_t add(const Student& student) {
+        rollNos.push_back(text.add(student.rollNo));
+        names.push_back(text.add(student.name));
+        marks.push_back(student.marks);
+        ranks.push_back(student.rank);
+        return static_cast<uint32_t>(marks.size() - 1);
+    }
+
+    size_t size() const {
+        return marks.size();
+    }
+
+    StudentView row(uint32_t i) const {
+        return { rollNos[i], names[i], marks[i], ranks[i] };
+    }
+
+    int rank(uint32_t i) const {
+        return ranks[i];
+    }
+
+    Student copy(uint32_t i) const {
+        return Student(string(rollNos[i]), string(names[i]), marks[i], ranks[i]);
+    }
+
+    const float* marksColumn() const {
+        return marks.data();
+    }
+
+    size_t memoryUsage() const {
+        return text.memoryUsage() + (rollNos.capacity() + names.capacity()) * sizeof(string_view) +
+               marks.capacity() * sizeof(float) + ranks.capacity() * sizeof(int);
+    }
+};
+
+// Students in a run of consecutive ranks, read from the table one at a
+// time: the row lists of those ranks chained in rank order. Valid until the
+// next student is added.
+class StudentRange {
+private:
+    using Ranks = map<int, vector<uint32_t>>;
+
+    const StudentTable* table = nullptr;
+    Ranks::const_iterator first;
+    Ranks::const_iterator last;
+
+public:
+    class iterator {
+    private:
+        const StudentTable* table;
+        Ranks::const_iterator rank;
+        size_t at; // Position in rank->second, never at its end
+
+    public:
+        using iterator_category = input_iterator_tag;
+        using value_type = StudentView;
+        using difference_type = ptrdiff_t;
+        using pointer = void;
+        using reference = StudentView;
+
+        iterator(const StudentTable* table, Ranks::const_iterator rank) : table(table), rank(rank), at(0) {}
+
+        StudentView operator*() const {
+            return table->row(rank->second[at]);
+        }
+
+        // Rank row lists are never empty, so the next rank has a first row
+        iterator& operator++() {
+            if (++at == rank->second.size()) {
+                ++rank;
+                at = 0;
+            }
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator before = *this;
+            ++*this;
+            return before;
+        }
+
+        bool operator==(const iterator& other) const {
+            return rank == other.rank && at == other.at;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    StudentRange() = default;
+    StudentRange(const StudentTable* table, Ranks::const_iterator first, Ranks::const_iterator last)
+        : table(table), first(first), last(last) {}
+
+    iterator begin() const {
+        return iterator(table, first);
+    }
+
+    iterator end() const {
+        return iterator(table, last);
+    }
+
+    // Linear in the number of ranks covered
+    size_t size() const {
+        size_t count = 0;
+        for (auto it = first; it != last; ++it) {
+            count += it->second.size();
+        }
+        return count;
+    }
+
+    bool empty() const {
+        return first == last;
+    }
+
+    // Linear in the number of ranks covered
+    StudentView operator[](size_t i) const {
+        auto it = first;
+        while (i >= it->second.size()) {
+            i -= it->second.size();
+            ++it;
+        }
+        return table->row(it->second[i]);
+    }
+};
+
 class StudentManager {
 private:
-    unordered_map<int, vector<Student>> rankMap; // Maps rank to students
-    unordered_map<string, Student> rollNoMap; // Maps roll number to student
+    StudentTable table;
+    map<int, vector<uint32_t>> rankMap; // Maps rank to rows, ordered by rank
+    unordered_map<string_view, uint32_t> rollNoMap; // Maps roll number to row
 
 public:
-    void addStudent(const Student& student) {
-        // Add student to rank map
-        rankMap[student.rank].push_back(student);
-        // Add student to roll number map
-        rollNoMap[student.rollNo] = student;
+    // False if the roll number is already taken
+    bool addStudent(const Student& student) {
+        if (rollNoMap.count(student.rollNo) != 0) {
+            return false;
+        }
+        uint32_t row = table.add(student);
+        rankMap[student.rank].push_back(row);
+        rollNoMap.emplace(table.row(row).rollNo, row);
+        return true;
     }
 
-    Student* getStudentByRollNo(const string& rollNo) {
+    optional<StudentView> getStudentByRollNo(string_view rollNo) const {
         auto it = rollNoMap.find(rollNo);
         if (it != rollNoMap.end()) {
-            return &(it->second); // Return the student if found
+            return table.row(it->second); // Return the student if found
         }
-        return nullptr; // Return nullopt if not found
+        return nullopt; // Return nullopt if not found
     }
 
     // retrieve all students for a given rank
-    vector<Student> getStudentByRank(int rank) {
+    vector<Student> getStudentByRank(int rank) const {
+        vector<Student> students;
         auto it = rankMap.find(rank);
         if (it != rankMap.end()) {
-            return it->second; // Return the vector of students for the given rank
+            for (uint32_t row : it->second) {
+                students.push_back(table.copy(row));
+            }
+        }
+        return students; // Empty if no students found for the rank
+    }
+
+    // The same students without copying them, in the order they were added
+    StudentRange viewStudentsByRank(int rank) const {
+        auto it = rankMap.find(rank);
+        if (it == rankMap.end()) {
+            return StudentRange();
+        }
+        return StudentRange(&table, it, next(it));
+    }
+
+    // Students ranked firstRank to lastRank inclusive, best rank first and
+    // in the order they were added within a rank
+    StudentRange viewStudentsByRankRange(int firstRank, int lastRank) const {
+        if (firstRank > lastRank) {
+            return StudentRange();
+        }
+        return StudentRange(&table, rankMap.lower_bound(firstRank), rankMap.upper_bound(lastRank));
+    }
+
+    // Students with at least `threshold` marks, counted over the marks column
+    size_t countWithMarksAtLeast(float threshold) const {
+        const float* marks = table.marksColumn();
+        size_t count = 0;
+        for (size_t i = 0; i < table.size(); i++) {
+            count += marks[i] >= threshold;
+        }
+        return count;
+    }
+
+    // Bytes held by the table and both maps' row lists, not their buckets or nodes
+    size_t memoryUsage() const {
+        size_t bytes = table.memoryUsage() + rollNoMap.size() * (sizeof(string_view) + sizeof(uint32_t));
+        for (const auto& entry : rankMap) {
+            bytes += entry.second.capacity() * sizeof(uint32_t);
         }
-        return {}; // Return an empty vector if no students found for the rank
+        return bytes;
     }
 };
 
@@ -73,8 +319,8 @@ int main() {
     manager.addStudent(Student("R004", "David", 88.0, 2));
 
     // retrieve by roll number
-    Student* student = manager.getStudentByRollNo("R002");
-    if (student != nullptr) {
+    auto student = manager.getStudentByRollNo("R002");
+    if (student) {
         cout << "Student found: " << student->name << endl;
     } else {
         cout << "Student not found." << endl;
@@ -86,5 +332,15 @@ int main() {
     for (const auto& student : topRankers) {
         cout << "Roll No: " << student.rollNo << ", Name: " << student.name << ", Marks: " << student.marks << endl;
     }
+
+    // retrieve a range of ranks without copying
+    manager.addStudent(Student("R005", "Eve", 70.0, 3));
+    manager.addStudent(Student("R006", "Frank", 92.5, 1));
+    cout << "Students with rank 1 to 2:" << endl;
+    for (StudentView view : manager.viewStudentsByRankRange(1, 2)) {
+        cout << "Rank: " << view.rank << ", Roll No: " << view.rollNo << ", Name: " << view.name << endl;
+    }
+
+    cout << manager.countWithMarksAtLeast(85) << " students with 85 marks or more" << endl;
     return 0;
 }
\ No newline at end of file